@@ -12,86 +12,482 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include "ActorNode.h"
 #include "ActorNode.cpp"
+#include "Arena.h"
+#include "Arena.cpp"
+#include "BoundedQueue.h"
 #include "Movie.h"
 #include "Movie.cpp"
+#include "StringTable.h"
+#include "StringTable.cpp"
+#include "CastRoles.h"
+#include "CastRoles.cpp"
+#include "CsrGraph.h"
+#include "CsrGraph.cpp"
+#include "CompressedGraph.h"
+#include "CompressedGraph.cpp"
+#include "BipartiteGraph.h"
+#include "BipartiteGraph.cpp"
+#include "ConnectionIndex.h"
+#include "ConnectionIndex.cpp"
+#include "Landmarks.h"
+#include "Landmarks.cpp"
+#include "PathSearch.h"
+#include "SearchQueue.h"
+#include "SearchQueue.cpp"
+#include "SearchWorkspace.h"
+#include "SearchWorkspace.cpp"
+#include "UnionFind.h"
+#include "UnionFind.cpp"
+#include "SnapshotFile.h"
+#include "SnapshotFile.cpp"
+#include "MappedFile.h"
+#include "MappedFile.cpp"
+#include "NodeOrder.h"
+#include "ThreadPool.h"
+#include "ThreadPool.cpp"
+#include "TsvScanner.h"
+#include "TsvScanner.cpp"
 #include "ActorGraph.h"
 using namespace std;
 
-ActorGraph::ActorGraph(void) {} // Constructor
+ActorGraph::ActorGraph(void) : next_movie(0), pool(new ThreadPool(1)),
+                               weight_mode(UNIT_WEIGHTS) {} // Constructor
 
-bool ActorGraph::loadFromFile(const char* in_filename, bool use_weighted_edges) {
-    ifstream infile(in_filename);  // initialize the file stream
+/** sets how many threads (including the caller) the loaders may use **/
+void ActorGraph::setThreads(unsigned num_threads) {
+    pool.reset(new ThreadPool(num_threads == 0 ? 1 : num_threads));
+}
 
-    bool have_header = false;
+/* A movie inside a shard is identified by the title and the year exactly as
+ * they appear in the file, both still pointing into the mapping.
+ */
+struct ShardMovieKey {
+    string_view title;
+    string_view year;
 
-    while (infile) {  // keep reading lines until the end of file is reached
-        string s;
+    bool operator==(const ShardMovieKey& other) const {
+        return title == other.title && year == other.year;
+    }
+};
 
-        // get the next line
-        if (!getline( infile, s )) break;
+struct ShardMovieKeyHash {
+    size_t operator()(const ShardMovieKey& key) const {
+        return hash<string_view>()(key.title) * 31 + hash<string_view>()(key.year);
+    }
+};
 
-        if (!have_header) {
-            // skip the header
-            have_header = true;
-            continue;
-        }
+/* Result of parsing one chunk of the cast file on its own.  Names get local
+ * ids in order of first appearance within the chunk and every row becomes a
+ * pair of local ids, so merging the shards in file order reproduces exactly
+ * what the serial loader would have built.
+ */
+struct LoadShard {
+    string_view text;
+    unordered_map<string_view, unsigned> actor_ids;
+    vector<string_view> actors;
+    unordered_map<ShardMovieKey, unsigned, ShardMovieKeyHash> movie_ids;
+    vector<ShardMovieKey> movies;
+    vector<int> years;
+    vector<pair<unsigned, unsigned>> rows; // (actor, movie) in file order
+};
+
+/** interns a name into the string table and keeps the name -> actor and
+ *   name -> movie tables the same length as the table **/
+uint32_t ActorGraph::internName(string_view name) {
+    uint32_t id = names.intern(name);
+    if(id == actor_of_name.size()) {
+        actor_of_name.push_back(NO_ID);
+        movie_of_name.push_back(NO_ID);
+    }
+    return id;
+}
 
-        istringstream ss( s );
-        vector <string> record;
+/** returns the id of the movie stored under title#@year, creating it the first
+ *   time the key is seen.  This is the only place a movie key is copied **/
+uint32_t ActorGraph::internMovie(string_view fmt_title, int year) {
+    uint32_t name = internName(fmt_title);
+    if(movie_of_name[name] == NO_ID) {
+        movie_of_name[name] = movies.size();
+        movies.emplace_back(name, year);
+    }
+    return movie_of_name[name];
+}
 
-        while (ss) {
-            string next;
+/** returns the id of the actor with the given name, creating it the first time
+ *   the name is seen.  This is the only place an actor name is copied **/
+uint32_t ActorGraph::internActor(string_view actor_name) {
+    uint32_t name = internName(actor_name);
+    if(actor_of_name[name] == NO_ID) {
+        actor_of_name[name] = actors.size();
+        actors.emplace_back(name);
+    }
+    return actor_of_name[name];
+}
 
-            // get the next string before hitting a tab character and put it in 'next'
-            if (!getline( ss, next, '\t' )) break;
+/** adds one actor/movie/year row to the graph.  The year is parsed with stoi
+ *   so malformed years fail exactly as they always have **/
+void ActorGraph::addRecord(string_view actor_name, string_view movie_title,
+                           string_view movie_year) {
+    int year = stoi(string(movie_year));
 
-            record.push_back( next );
-        }
+    // key for movie_map title#@year, built in a reused buffer
+    key_buf.assign(movie_title.data(), movie_title.size());
+    key_buf += "#@";
+    key_buf.append(movie_year.data(), movie_year.size());
+
+    uint32_t movie = internMovie(key_buf, year);
+    uint32_t actor = internActor(actor_name);
+
+    rows.push_back(make_pair(movie, actor)); // joins the cast in packCasts()
+}
+
+/**moves the rows read since the last call into the casts.  All casts are
+ *   laid out back to back in one block of the arena, every movie keeping its
+ *   actors in the order they were read, and the movies view their part **/
+void ActorGraph::packCasts() {
+    if(rows.empty()) return;
+
+    vector<uint64_t> cast_offsets(movies.size() + 1, 0);
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        cast_offsets[m + 1] = movies[m].getCast().size();
+    }
+    for(auto& r: rows) {
+        cast_offsets[r.first + 1]++;
+    }
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        cast_offsets[m + 1] += cast_offsets[m];
+    }
 
-        if (record.size() != 3) {
+    uint32_t* cast_actors = arena.allocate<uint32_t>(cast_offsets[movies.size()]);
+    vector<uint64_t> next_slot(cast_offsets.begin(), cast_offsets.end() - 1);
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        const FlatArray<uint32_t>& cast = movies[m].getCast();
+        copy(cast.begin(), cast.end(), cast_actors + next_slot[m]);
+        next_slot[m] += cast.size();
+    }
+    for(auto& r: rows) {
+        cast_actors[next_slot[r.first]++] = r.second;
+    }
+    vector<pair<uint32_t, uint32_t>>().swap(rows);
+
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        movies[m].setCast(cast_actors + cast_offsets[m], cast_offsets[m + 1] - cast_offsets[m]);
+    }
+}
+
+/**reads the cast file through a stream, "-" reads the standard input, so
+ *   a pipe can be loaded without landing it on disk.  See loadFromStream() **/
+bool ActorGraph::loadFromFile(const char* in_filename, bool use_weighted_edges) {
+    if(string_view(in_filename) == "-") {
+        return loadFromStream(cin, use_weighted_edges);
+    }
+
+    ifstream infile(in_filename, ios::binary);  // initialize the file stream
+    if(!infile || !loadFromStream(infile, use_weighted_edges)) {
+        cerr << "Failed to read " << in_filename << "!\n";
+        return false;
+    }
+    return true;
+}
+
+/**parses the rows of a single chunk into shard local tables **/
+static void parseShard(LoadShard& shard) {
+    TsvReader reader(shard.text);
+    string_view record[3];
+    size_t fields;
+
+    while(reader.nextRow(record, 3, fields)) {
+        if(fields != 3) {
             // we should have exactly 3 columns
             continue;
         }
 
-        string actor_name(record[0]);
-        string movie_title(record[1]);
-        int movie_year = stoi(record[2]);
+        ShardMovieKey key = { record[1], record[2] };
+        auto movie = shard.movie_ids.emplace(key, shard.movies.size());
+        if(movie.second) {
+            shard.movies.push_back(key);
+            shard.years.push_back(stoi(string(record[2])));
+        }
+
+        auto actor = shard.actor_ids.emplace(record[0], shard.actors.size());
+        if(actor.second) {
+            shard.actors.push_back(record[0]);
+        }
+
+        shard.rows.push_back(make_pair(actor.first->second, movie.first->second));
+    }
+}
+
+/**interns the names of one parsed shard and appends its rows to the casts.
+ *   Shards must be merged in file order to keep the graph deterministic **/
+void ActorGraph::mergeShard(const LoadShard& shard) {
+    vector<uint32_t> movie_ids;
+    movie_ids.reserve(shard.movies.size());
+
+    for(unsigned i = 0; i < shard.movies.size(); i++) {
+        key_buf.assign(shard.movies[i].title.data(), shard.movies[i].title.size());
+        key_buf += "#@";
+        key_buf.append(shard.movies[i].year.data(), shard.movies[i].year.size());
+        movie_ids.push_back(internMovie(key_buf, shard.years[i]));
+    }
+
+    vector<uint32_t> actor_ids;
+    actor_ids.reserve(shard.actors.size());
+
+    for(auto& a: shard.actors) {
+        actor_ids.push_back(internActor(a));
+    }
+
+    for(auto& r: shard.rows) {
+        rows.push_back(make_pair(movie_ids[r.second], actor_ids[r.first]));
+    }
+}
+
+/* A block of whole rows of the cast file on its way through the stream
+ * loader.  The shard views text, so blocks are only passed by pointer.
+ */
+struct LoadBlock {
+    size_t seq; // blocks are merged in file order
+    string text;
+    LoadShard shard;
+};
+
+typedef chrono::steady_clock LoadClock;
 
-        // key for movie_map title#@year
-        string fmt_title = movie_title + "#@" +  record[2];
-        // find the movie object for our key if it exists
-        Movie* movie;
+// Returns the nanoseconds since start.
+static long long nanosSince(LoadClock::time_point start) {
+    return chrono::duration_cast<chrono::nanoseconds>(LoadClock::now() - start).count();
+}
 
-        if(movie_map.find(fmt_title) == movie_map.end()) { 
-            movie = new Movie(movie_title, movie_year); // create movie object if one does not exist
-            movie_map.insert(make_pair(fmt_title, movie)); // add it to the map
+/**loads the cast file from a stream in three stages that overlap: a reader
+ *   thread cuts the stream into blocks of whole rows, parser threads split
+ *   the rows of every block and intern its names locally (parseShard()), and
+ *   the calling thread merges the parsed blocks into the graph in file order
+ *   (mergeShard()).  Bounded queues connect the stages, so only a few blocks
+ *   are in memory at once.  The graph is the same as loadFromMappedFile()
+ *   builds.  What every stage did is in loadStats().  Returns false if the
+ *   stream could not be read **/
+bool ActorGraph::loadFromStream(istream& in, bool use_weighted_edges) {
+    const size_t BLOCK_SIZE = 4 << 20;
+    unsigned num_parsers = pool->size() > 1 ? pool->size() - 1 : 1;
+    BoundedQueue<unique_ptr<LoadBlock>> to_parse(2 * num_parsers);
+    BoundedQueue<unique_ptr<LoadBlock>> to_merge(2 * num_parsers);
+    LoadClock::time_point start = LoadClock::now();
+    load_stats = LoadStats();
+    load_stats.parsers = num_parsers;
+
+    // the first exception of any stage stops all of them and is rethrown
+    mutex stats_lock;
+    exception_ptr error;
+    auto fail = [&]() {
+        lock_guard<mutex> guard(stats_lock);
+        if(!error) error = current_exception();
+        to_parse.close();
+        to_merge.close();
+    };
+
+    thread reader([&] {
+        try {
+            string carry; // the unfinished row at the end of the last block
+            bool have_header = false;
+            while(true) {
+                unique_ptr<LoadBlock> block(new LoadBlock());
+                block->text.swap(carry);
+                size_t carried = block->text.size();
+                block->text.resize(carried + BLOCK_SIZE);
+
+                LoadClock::time_point t = LoadClock::now();
+                in.read(&block->text[carried], BLOCK_SIZE);
+                size_t got = in.gcount();
+                load_stats.read_ns += nanosSince(t);
+                load_stats.bytes += got;
+                block->text.resize(carried + got);
+                bool last = got < BLOCK_SIZE;
+
+                if(!have_header) {
+                    // skip the header
+                    size_t eol = block->text.find('\n');
+                    if(eol == string::npos && !last) {
+                        carry.swap(block->text);
+                        continue;
+                    }
+                    block->text.erase(0, eol == string::npos ? string::npos : eol + 1);
+                    have_header = true;
+                }
+
+                // rows up to the last '\n', the whole rest at the end
+                if(!last) {
+                    size_t eol = block->text.rfind('\n');
+                    size_t rows_end = eol == string::npos ? 0 : eol + 1;
+                    carry.assign(block->text, rows_end, string::npos);
+                    block->text.resize(rows_end);
+                }
+                if(!block->text.empty()) {
+                    block->seq = load_stats.blocks++;
+                    t = LoadClock::now();
+                    bool pushed = to_parse.push(move(block));
+                    load_stats.read_wait_ns += nanosSince(t);
+                    if(!pushed) break;
+                }
+                if(last) break;
+            }
         }
-        else {
-            movie = movie_map[fmt_title];
+        catch(...) {
+            fail();
         }
+        to_parse.close();
+    });
+
+    atomic<unsigned> running(num_parsers);
+    vector<thread> parsers;
+    for(unsigned p = 0; p < num_parsers; p++) {
+        parsers.emplace_back([&] {
+            long long busy_ns = 0;
+            long long wait_ns = 0;
+            uint64_t rows = 0;
+            try {
+                unique_ptr<LoadBlock> block;
+                while(true) {
+                    LoadClock::time_point t = LoadClock::now();
+                    bool popped = to_parse.pop(block);
+                    wait_ns += nanosSince(t);
+                    if(!popped) break;
+
+                    t = LoadClock::now();
+                    block->shard.text = block->text;
+                    parseShard(block->shard);
+                    rows += block->shard.rows.size();
+                    busy_ns += nanosSince(t);
+
+                    t = LoadClock::now();
+                    bool pushed = to_merge.push(move(block));
+                    wait_ns += nanosSince(t);
+                    if(!pushed) break;
+                }
+            }
+            catch(...) {
+                fail();
+            }
+
+            lock_guard<mutex> guard(stats_lock);
+            load_stats.rows += rows;
+            load_stats.parse_ns += busy_ns;
+            load_stats.parse_wait_ns += wait_ns;
+            if(--running == 0) to_merge.close();
+        });
+    }
 
-        // find the actor object if it exists
-        ActorNode* actor;
-
-        if(actor_map.find(actor_name) == actor_map.end()) { 
-            actor = new ActorNode(actor_name); // create actor object if it does not exist
-            actor_map.insert(make_pair(actor_name, actor)); // add it to the map
+    // merge the blocks in file order, parsers may finish them out of order
+    map<size_t, unique_ptr<LoadBlock>> parsed;
+    size_t next_seq = 0;
+    unique_ptr<LoadBlock> block;
+    while(true) {
+        LoadClock::time_point t = LoadClock::now();
+        bool popped = to_merge.pop(block);
+        load_stats.merge_wait_ns += nanosSince(t);
+        if(!popped) break;
+
+        t = LoadClock::now();
+        size_t seq = block->seq;
+        parsed[seq] = move(block);
+        try {
+            for(auto it = parsed.find(next_seq); it != parsed.end(); it = parsed.find(++next_seq)) {
+                mergeShard(it->second->shard);
+                parsed.erase(it);
+            }
         }
-        else {
-            actor = actor_map[actor_name];
+        catch(...) {
+            fail();
         }
+        load_stats.merge_ns += nanosSince(t);
+    }
 
-        movie->addActor(actor); // add the actor to the cast of the movie
+    reader.join();
+    for(auto& p: parsers) {
+        p.join();
     }
+    if(error) rethrow_exception(error);
+    if(in.bad()) return false;
+
+    LoadClock::time_point t = LoadClock::now();
+    packCasts();
+    load_stats.merge_ns += nanosSince(t);
+    load_stats.total_ns = nanosSince(start);
+
+    if(use_weighted_edges) {
+        useWeights();
+    }
+
+    return true;
+}
 
-    if (!infile.eof()) {
+/**zero-copy variant of loadFromFile.  The file is mapped into memory and every
+ *   row is split into string_views that point straight into the mapping, so
+ *   the only copies made are of names seen for the first time **/
+bool ActorGraph::loadFromMappedFile(const char* in_filename, bool use_weighted_edges) {
+    MappedFile infile;
+
+    if(!infile.open(in_filename)) {
         cerr << "Failed to read " << in_filename << "!\n";
         return false;
     }
+
+    string_view rest = infile.view();
+
+    // skip the header
+    size_t header_end = rest.find('\n');
+    rest.remove_prefix(header_end == string_view::npos ? rest.size() : header_end + 1);
+
+    if(pool->size() == 1) {
+        TsvReader reader(rest);
+        string_view record[3];
+        size_t fields;
+
+        while(reader.nextRow(record, 3, fields)) {  // keep reading rows until the end of file is reached
+            if(fields != 3) {
+                // we should have exactly 3 columns
+                continue;
+            }
+
+            addRecord(record[0], record[1], record[2]);
+        }
+    }
+    else {
+        // cut the rows into a few chunks per thread, always right after a '\n'
+        size_t num_shards = pool->size() * 4;
+        vector<LoadShard> shards(num_shards);
+        size_t begin = 0;
+
+        for(size_t i = 0; i < num_shards; i++) {
+            size_t end = rest.size() * (i + 1) / num_shards;
+            if(end < begin) end = begin;
+            if(end < rest.size()) {
+                size_t eol = rest.find('\n', end == 0 ? 0 : end - 1);
+                end = eol == string_view::npos ? rest.size() : eol + 1;
+            }
+            shards[i].text = rest.substr(begin, end - begin);
+            begin = end;
+        }
+
+        pool->parallelFor(num_shards, [&](size_t i, unsigned) {
+            parseShard(shards[i]);
+        });
+
+        for(auto& shard: shards) {
+            mergeShard(shard);
+        }
+    }
     infile.close();
+    packCasts();
 
     if(use_weighted_edges) {
         useWeights();
@@ -100,118 +496,414 @@ bool ActorGraph::loadFromFile(const char* in_filename, bool use_weighted_edges)
     return true;
 }
 
-/**builds graph by going through the movies and calls makeEdges() to make
- *   connections between the neighbors **/
-void ActorGraph::build() {
-    for(auto& m: movie_map) {
-        m.second->makeEdges();
+/**writes the graph to a binary snapshot: the string table with its index,
+ *   the name -> id tables, every movie with its year, weight and cast, and
+ *   whichever adjacency, connection index and landmark table have been built,
+ *   and the ranks of renumbered actors.  The weight mode goes in the flags **/
+bool ActorGraph::saveSnapshot(const char* out_filename) const {
+    vector<uint32_t> actor_names;
+    actor_names.reserve(actors.size());
+    for(auto& a: actors) {
+        actor_names.push_back(a.name);
+    }
+
+    vector<uint32_t> movie_names;
+    vector<int> movie_years;
+    vector<int> movie_weights;
+    vector<uint64_t> cast_offsets(1, 0);
+    vector<uint32_t> cast_actors;
+
+    for(auto& m: movies) {
+        movie_names.push_back(m.name);
+        movie_years.push_back(m.year);
+        movie_weights.push_back(m.getWeight());
+        cast_actors.insert(cast_actors.end(), m.getCast().begin(), m.getCast().end());
+        cast_offsets.push_back(cast_actors.size());
+    }
+
+    SnapshotWriter out;
+    names.save(out);
+    out.add(SNAP_ACTOR_NAMES, actor_names);
+    out.add(SNAP_ACTOR_OF_NAME, actor_of_name);
+    out.add(SNAP_MOVIE_OF_NAME, movie_of_name);
+    out.add(SNAP_MOVIE_NAMES, movie_names);
+    out.add(SNAP_MOVIE_YEARS, movie_years);
+    out.add(SNAP_MOVIE_WEIGHTS, movie_weights);
+    out.add(SNAP_CAST_OFFSETS, cast_offsets);
+    out.add(SNAP_CAST_ACTORS, cast_actors);
+
+    if(hasClique()) {
+        csr.save(out);
+    }
+    if(hasBipartite()) {
+        incidence_lists.save(out);
+    }
+    if(connections.built()) {
+        connections.save(out);
+    }
+    if(landmarks.built()) {
+        landmarks.save(out);
+    }
+    if(!actor_ranks.empty()) {
+        out.add(SNAP_ACTOR_RANKS, actor_ranks);
     }
+
+    if(!out.write(out_filename, weight_mode)) {
+        cerr << "Failed to write " << out_filename << "!\n";
+        return false;
+    }
+    return true;
 }
 
-/**to use when using Dijkstra's algorithm.  Method goes through movies and
- *   calls calcWeight to determine the weights of the neighbors **/
-void ActorGraph::useWeights() {
-    for(auto& m: movie_map) {
-        m.second->calcWeight();
+/**returns whether every id of ids is below bound, so an array read from a
+ *   snapshot cannot send a search outside the arrays it indexes **/
+static bool allBelow(const FlatArray<uint32_t>& ids, uint32_t bound) {
+    for(uint32_t id: ids) {
+        if(id >= bound) return false;
     }
+    return true;
 }
 
-/**helper method to sort the movies by order of year by using a priority queue
- *   goes through all the movies and adds them to the priority queue **/ 
-void ActorGraph::sortMovies() {
-    sorted_movies = priority_queue<Movie*, vector<Movie*>, MoviePtrComp> ();
+/**replaces the graph by the one stored in a snapshot.  The file is mapped and
+ *   its arrays are used in place, only the actor and movie objects are created,
+ *   so a graph is ready without parsing anything.  The sizes of the arrays
+ *   have to agree, the actor and movie ids in them have to exist and the
+ *   weight mode has to be known **/
+bool ActorGraph::loadSnapshot(const char* in_filename) {
+    SnapshotReader in(snapshot_file);
+    string error;
+    FlatArray<uint32_t> actor_names;
+    FlatArray<uint32_t> movie_names;
+    FlatArray<int> movie_years;
+    FlatArray<int> movie_weights;
+    FlatArray<uint64_t> cast_offsets;
+    FlatArray<uint32_t> cast_actors;
+
+    if(!in.open(in_filename, error)) {
+        cerr << "Failed to read " << in_filename << ": " << error << "!\n";
+        return false;
+    }
 
-    for(auto& m: movie_map) {
-        sorted_movies.push(m.second);
+    bool ok = in.flags() <= YEAR_WEIGHTS &&
+              names.load(in) &&
+              in.get(SNAP_ACTOR_NAMES, actor_names) &&
+              in.get(SNAP_ACTOR_OF_NAME, actor_of_name) &&
+              in.get(SNAP_MOVIE_OF_NAME, movie_of_name) &&
+              in.get(SNAP_MOVIE_NAMES, movie_names) &&
+              in.get(SNAP_MOVIE_YEARS, movie_years) &&
+              in.get(SNAP_MOVIE_WEIGHTS, movie_weights) &&
+              in.get(SNAP_CAST_OFFSETS, cast_offsets) &&
+              in.get(SNAP_CAST_ACTORS, cast_actors) &&
+              actor_of_name.size() == names.size() &&
+              movie_of_name.size() == names.size() &&
+              movie_years.size() == movie_names.size() &&
+              movie_weights.size() == movie_names.size() &&
+              cast_offsets.size() == movie_names.size() + 1 &&
+              cast_offsets.back() == cast_actors.size() &&
+              allBelow(cast_actors, actor_names.size()) &&
+              (!in.has(SNAP_CSR_OFFSETS) || (csr.load(in) && csr.numNodes() == actor_names.size() &&
+                                             allBelow(csr.targets, actor_names.size()) &&
+                                             allBelow(csr.movies, movie_names.size()))) &&
+              (!in.has(SNAP_BIP_ACTOR_OFFSETS) || (incidence_lists.load(in) &&
+                                                   incidence_lists.numNodes() == actor_names.size() &&
+                                                   allBelow(incidence_lists.actor_movies,
+                                                            movie_names.size()))) &&
+              (!in.has(SNAP_CONN_PARENTS) || (connections.load(in) &&
+                                              connections.numActors() == actor_names.size())) &&
+              (!in.has(SNAP_LANDMARK_ACTORS) || (landmarks.load(in) &&
+                                                 landmarks.numActors() == actor_names.size()));
+
+    // the ranks of a renumbered graph have to be a permutation of the actors
+    actor_ranks.clear();
+    actor_of_rank.clear();
+    if(ok && in.has(SNAP_ACTOR_RANKS)) {
+        ok = in.get(SNAP_ACTOR_RANKS, actor_ranks) && actor_ranks.size() == actor_names.size();
+        actor_of_rank.assign(actor_ranks.size(), NO_ID);
+        for(uint32_t a = 0; ok && a < actor_ranks.size(); a++) {
+            uint32_t rank = actor_ranks[a];
+            ok = rank < actor_ranks.size() && actor_of_rank[rank] == NO_ID;
+            if(ok) actor_of_rank[rank] = a;
+        }
     }
-}
 
-/**method to be used by when ufind is called as the algorithm.  Goes through
- *    each movie years by the priority queue, and calls method ufind() */
-bool ActorGraph::ufindByYear()
-{
-    if(sorted_movies.size() == 0) { //the priority queue is empty
+    if(!ok) {
+        cerr << "Failed to read " << in_filename << ": inconsistent snapshot!\n";
         return false;
     }
 
-    curr_year = sorted_movies.top()->year;
-    Movie* curr_movie;
+    weight_mode = (WeightMode) in.flags();
 
-    while(1) {
-        if(sorted_movies.top()->year != curr_year) break;
-        if(sorted_movies.size() == 0) break;
+    actors.clear();
+    actors.reserve(actor_names.size());
+    for(uint32_t name: actor_names) {
+        actors.emplace_back(name);
+    }
 
-        curr_movie = sorted_movies.top(); // get the next movie
-        curr_movie->ufind(); // builds ufind graph
-        sorted_movies.pop();
+    movies.clear();
+    movies.reserve(movie_names.size());
+    for(uint32_t m = 0; m < movie_names.size(); m++) {
+        movies.emplace_back(movie_names[m], movie_years[m], movie_weights[m],
+                            cast_actors.data() + cast_offsets[m],
+                            cast_offsets[m + 1] - cast_offsets[m]);
     }
+
     return true;
 }
 
-/** method to go through the priority queue of sorted movies and build the 
- *      graph by each year **/
-bool ActorGraph::buildByYear() {
-    if(sorted_movies.size() == 0) {  //the priority queue is empty
-        return false;
+/**builds graph by connecting every pair of actors that share a movie in
+ *   the compressed sparse row adjacency used by the searches, on all the
+ *   threads of the graph, see CsrGraph::build() **/
+void ActorGraph::build() {
+    csr.build(movies, actors.size(), arena, *pool);
+}
+
+/**alternative to build() that keeps the graph bipartite: it only records
+ *   which movies every actor played in and never creates the co-star edges
+ *   of a cast **/
+void ActorGraph::buildBipartite() {
+    incidence_lists.build(movies, actors.size());
+}
+
+/**alternative to build() for casts whose clique does not fit in memory:
+ *   the same edges sorted and stored as varint gaps with packed movie ids,
+ *   see CompressedGraph **/
+void ActorGraph::buildCompressed() {
+    packed.build(movies, actors.size(), arena, *pool);
+}
+
+/**builds the index that answers in which year two actors become connected
+ *   without replaying the movies, see ConnectionIndex **/
+void ActorGraph::buildConnections() {
+    connections.build(movies, actors.size());
+}
+
+/**picks count landmarks and stores the distance of every actor from each
+ *   for the A* search, see selectLandmarks().  Searches the clique if it was
+ *   built, else the compressed clique, else the incidence lists, and starts
+ *   from the actor with the most movies **/
+void ActorGraph::buildLandmarks(uint32_t count) {
+    vector<uint32_t> num_movies(actors.size(), 0);
+    uint32_t seed = 0;
+    for(auto& m: movies) {
+        for(uint32_t actor: m.getCast()) {
+            if(++num_movies[actor] > num_movies[seed]) seed = actor;
+        }
     }
 
-    curr_year = sorted_movies.top()->year;
-    Movie* curr_movie;
+    SearchWorkspace ws;
+    HeapQueue heap;
+    initWorkspace(ws);
+    if(hasClique()) {
+        selectLandmarks(csr, ws, heap, count, seed, landmarks);
+    }
+    else if(hasCompressed()) {
+        selectLandmarks(packed, ws, heap, count, seed, landmarks);
+    }
+    else {
+        selectLandmarks(incidence_lists, ws, heap, count, seed, landmarks);
+    }
+}
 
-    while(1) {
-        if(sorted_movies.top()->year != curr_year) break;
-        if(sorted_movies.size() == 0) break;   
-        
-        curr_movie = sorted_movies.top(); //get the next movie 
-        curr_movie->makeEdges();  //make connections between actors 
-        sorted_movies.pop();
+/**renumbers the actors in the order how gives on the adjacency that was
+ *   built, see NodeOrder.h, and carries the new ids through the name table,
+ *   the casts and everything built so far.  Names keep finding their actor
+ *   and the searches break ties by the ids before the first renumbering,
+ *   see SearchWorkspace::rank(), so pairs files and printed paths do not
+ *   change.  Call it before any search or ufind, workspaces have to be set
+ *   up again.  Returns the old ids in their new order **/
+vector<uint32_t> ActorGraph::reorder(NodeOrdering how) {
+    uint32_t num_actors = actors.size();
+    bool has_clique = hasClique();
+    bool has_compressed = hasCompressed();
+    bool has_bipartite = hasBipartite();
+
+    SearchWorkspace ws;
+    initWorkspace(ws);
+    vector<uint32_t> order(num_actors);
+    iota(order.begin(), order.end(), 0); // nothing built to take an order from
+    if(has_clique) {
+        order = orderNodes(csr, ws, how);
     }
-    return true;
+    else if(has_compressed) {
+        order = orderNodes(packed, ws, how);
+    }
+    else if(has_bipartite) {
+        order = orderNodes(incidence_lists, ws, how);
+    }
+
+    vector<uint32_t> new_id(num_actors);
+    for(uint32_t a = 0; a < num_actors; a++) {
+        new_id[order[a]] = a;
+    }
+
+    // the rank of an actor stays its id before the first renumbering
+    FlatArray<uint32_t> ranks(num_actors, 0);
+    actor_of_rank.assign(num_actors, 0);
+    for(uint32_t a = 0; a < num_actors; a++) {
+        ranks[a] = actor_ranks.empty() ? order[a] : actor_ranks[order[a]];
+        actor_of_rank[ranks[a]] = a;
+    }
+    actor_ranks = ranks;
+
+    vector<ActorNode> renumbered;
+    renumbered.reserve(num_actors);
+    for(uint32_t old_id: order) {
+        renumbered.push_back(actors[old_id]);
+    }
+    actors.swap(renumbered);
+
+    actor_of_name.own();
+    for(auto& actor: actor_of_name) {
+        if(actor != NO_ID) actor = new_id[actor];
+    }
+
+    uint64_t cast_size = 0;
+    for(auto& m: movies) {
+        cast_size += m.getCast().size();
+    }
+    uint32_t* cast_actors = arena.allocate<uint32_t>(cast_size);
+    for(auto& m: movies) {
+        uint32_t size = m.getCast().size();
+        for(uint32_t i = 0; i < size; i++) {
+            cast_actors[i] = new_id[m.getCast()[i]];
+        }
+        m.setCast(cast_actors, size);
+        cast_actors += size;
+    }
+
+    if(has_clique) {
+        csr.permute(order, new_id, arena);
+    }
+    if(has_compressed) {
+        buildCompressed(); // the gaps depend on the ids, encode them again
+    }
+    if(has_bipartite) {
+        buildBipartite();
+    }
+    if(connections.built()) {
+        buildConnections();
+    }
+    if(landmarks.built()) {
+        landmarks.permute(order, new_id);
+    }
+    return order;
 }
 
-/**method to reinitialize all the neighbors each time you go through a new 
- *      pair of actors to test **/
-void ActorGraph::resetNeighbors() {
-    for(auto& a: actor_map) {
-        a.second->neighbors = vector<ActorNode*> ();
-        a.second->edge_map = unordered_map<ActorNode*, pair<string, int> > ();
+/**sizes ws for this graph and hands it the ranks of the actors if they
+ *   were renumbered, so its searches break ties as before reorder() **/
+void ActorGraph::initWorkspace(SearchWorkspace& ws) const {
+    ws.resize(numActors(), numMovies());
+    if(actor_ranks.empty()) {
+        ws.setRanks(nullptr, nullptr);
+    }
+    else {
+        ws.setRanks(actor_ranks.data(), actor_of_rank.data());
     }
 }
 
-/** helper method to get the size of each neighbor **/
-int ActorGraph::neighborSize(string actor_name) {
-    ActorNode* actor = actor_map[actor_name];
-    return actor->neighborSize();
+/**to use when using Dijkstra's algorithm.  Method goes through movies and
+ *   calls calcWeight to determine the weights of the neighbors **/
+void ActorGraph::useWeights() {
+    for(auto& m: movies) {
+        m.calcWeight();
+    }
+    weight_mode = AGE_WEIGHTS;
 }
 
-/** helper method to get the actor from the file **/
-ActorNode* ActorGraph::getActor(string actor_name) {
-    return actor_map[actor_name];
+/**to use when asking in which year actors become connected.  The weight of
+ *   every movie becomes its year, so build() keeps the earliest movie that
+ *   connects two actors and an edge is usable from the year its weight says **/
+void ActorGraph::useYears() {
+    for(auto& m: movies) {
+        m.useYear();
+    }
+    weight_mode = YEAR_WEIGHTS;
 }
 
-/**helper method to reset the nodes in the graph for each time you go through
- *      a new pair of actors to test **/
-void ActorGraph::resetNodes() {
-    for(auto& a: actor_map) {
-      a.second->dist = numeric_limits<int>::max(); //set to infinity
-      a.second->prev = nullptr;
-      a.second->done = false;
-      a.second->parent = nullptr;
-      a.second->size = 1;
+/**returns the smallest and largest weight of any movie, so of any edge,
+ *   both are 1 for a graph without movies **/
+int ActorGraph::minWeight() const {
+    int min_weight = movies.empty() ? 1 : INT_MAX;
+    for(auto& m: movies) {
+        min_weight = min(min_weight, m.getWeight());
     }
+    return min_weight;
 }
 
-/**method to delete all the nodes at the end **/
-void ActorGraph::deleteAll() {
-    for(auto& m: movie_map) {
-        delete m.second;
+int ActorGraph::maxWeight() const {
+    int max_weight = movies.empty() ? 1 : INT_MIN;
+    for(auto& m: movies) {
+        max_weight = max(max_weight, m.getWeight());
     }
+    return max_weight;
+}
 
-    for(auto& a: actor_map) {
-        delete a.second;
+/**returns every year that has a movie, in increasing order **/
+vector<int> ActorGraph::movieYears() const {
+    vector<int> years;
+    for(auto& m: movies) {
+        years.push_back(m.year);
+    }
+    sort(years.begin(), years.end());
+    years.erase(unique(years.begin(), years.end()), years.end());
+    return years;
+}
+
+/**helper method to sort the movies by order of year, ufindByYear() then
+ *   adds them from the earliest year on.  The order is only sorted the first
+ *   time, later calls just start over from the beginning **/ 
+void ActorGraph::sortMovies() {
+    if(movies_by_year.size() != movies.size()) {
+        movies_by_year.resize(movies.size());
+        for(uint32_t m = 0; m < movies.size(); m++) {
+            movies_by_year[m] = m;
+        }
+        stable_sort(movies_by_year.begin(), movies_by_year.end(),
+                    [this](uint32_t a, uint32_t b) { return movies[a].year < movies[b].year; });
+    }
+    next_movie = 0;
+}
+
+/**method to be used by when ufind is called as the algorithm.  Adds every
+ *    movie of the next year in the sorted order by calling method ufind() */
+bool ActorGraph::ufindByYear()
+{
+    if(next_movie == movies_by_year.size()) { //every year has been added
+        return false;
+    }
+
+    curr_year = movies[movies_by_year[next_movie]].year;
+
+    while(next_movie < movies_by_year.size()) {
+        Movie& curr_movie = movies[movies_by_year[next_movie]]; // get the next movie
+        if(curr_movie.year != curr_year) break;
+
+        curr_movie.ufind(sets); // builds ufind graph
+        next_movie++;
+    }
+    return true;
+}
+
+/** helper method to get the size of each neighbor **/
+int ActorGraph::neighborSize(string actor_name) {
+    return csr.degree(getActor(actor_name));
+}
+
+/** helper method to get the id of an actor from the file, NO_ID if unknown **/
+uint32_t ActorGraph::getActor(string_view actor_name) const {
+    uint32_t name = names.find(actor_name);
+    return name == StringTable::NONE ? NO_ID : actor_of_name[name];
+}
+
+/**helper method to reset the union-find sets for each time you go through
+ *      a new pair of actors to test, every actor is a set of its own again **/
+void ActorGraph::resetNodes() {
+    if(sets.size() != actors.size()) {
+        sets.resize(actors.size());
+    }
+    else {
+        sets.reset();
     }
 }
 
-ActorGraph::~ActorGraph() {
-    deleteAll();
-}
\ No newline at end of file
+ActorGraph::~ActorGraph() {}
\ No newline at end of file
@@ -4,74 +4,193 @@
  * Purpose: This file is meant to exist as a container for starter code that 
  *    you can use to read the input file format defined in movie_casts.tsv. 
  *    Feel free to modify any/all aspects as you wish. 
- *    Includes declaration of pointer comparisons and function declarations 
- *    of for ActorGraph.cpp
+ *    Includes the function declarations of for ActorGraph.cpp
  */
 
 #ifndef ACTORGRAPH_H
 #define ACTORGRAPH_H
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <queue>
-#include <unordered_map>
+#include <vector>
+#include <memory>
 #include "ActorNode.h"
+#include "Arena.h"
 #include "Movie.h"
+#include "BipartiteGraph.h"
+#include "ConnectionIndex.h"
+#include "Landmarks.h"
+#include "CsrGraph.h"
+#include "CompressedGraph.h"
+#include "FlatArray.h"
+#include "MappedFile.h"
+#include "NodeOrder.h"
+#include "SearchWorkspace.h"
+#include "StringTable.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
 using namespace std;
 
-/**Pointer comparison between two movies **/
-class MoviePtrComp
+struct LoadShard; // rows of one chunk of the cast file, see ActorGraph.cpp
+
+/** what the weight of an edge means, set by useWeights() and useYears() **/
+enum WeightMode
 {
-    public:
-        bool operator()(Movie*& lhs, Movie*& rhs) const
-        {
-            return *lhs < *rhs;
-        }
+    UNIT_WEIGHTS = 0,  // every movie weighs 1
+    AGE_WEIGHTS = 1,   // 1 + (2015 - year)
+    YEAR_WEIGHTS = 2   // the year of the movie
 };
 
-/**Pointer comparison between two actors **/
-class ActorPtrComp
+/** what the stages of the last loadFromStream() did, to tell which one holds
+ *  up the others.  busy is time spent working, wait is time blocked on a
+ *  queue, both summed over the threads of a stage **/
+struct LoadStats
 {
-    public:
-        bool operator()(ActorNode*& lhs, ActorNode*& rhs) const
-        {
-            return *lhs < *rhs;
-        }
+    uint64_t bytes = 0;  // read from the stream
+    uint64_t blocks = 0; // of whole rows handed to the parsers
+    uint64_t rows = 0;   // with 3 fields
+    unsigned parsers = 0;
+    long long read_ns = 0;       // in istream::read()
+    long long read_wait_ns = 0;  // on a full parse queue
+    long long parse_ns = 0;
+    long long parse_wait_ns = 0; // on an empty parse queue or a full merge queue
+    long long merge_ns = 0;      // interning the names and packing the casts
+    long long merge_wait_ns = 0; // on an empty merge queue
+    long long total_ns = 0;
 };
 
 class ActorGraph {
     protected:
-        unordered_map<string, Movie*> movie_map;
-        unordered_map<string, ActorNode*> actor_map;
-        priority_queue<Movie*, vector<Movie*>, MoviePtrComp> sorted_movies;
-        void deleteAll();
-
+        // every actor name and title#@year key is stored once in names,
+        // actors and movies are numbered densely in order of first appearance
+        StringTable names;
+        FlatArray<uint32_t> actor_of_name; // string id -> actor id or NO_ID
+        FlatArray<uint32_t> movie_of_name; // string id -> movie id or NO_ID
+        vector<ActorNode> actors;
+        vector<Movie> movies;
+        CsrGraph csr; // adjacency, filled in by build()
+        CompressedGraph packed; // compressed adjacency, filled in by buildCompressed()
+        BipartiteGraph incidence_lists; // filled in by buildBipartite()
+        ConnectionIndex connections; // filled in by buildConnections()
+        Landmarks landmarks; // filled in by buildLandmarks()
+        FlatArray<uint32_t> actor_ranks;   // id of every actor before reorder(), empty if never renumbered
+        FlatArray<uint32_t> actor_of_rank; // inverse of actor_ranks
+        vector<uint32_t> movies_by_year; // movie ids in order of year, see sortMovies()
+        size_t next_movie; // first movie of movies_by_year ufindByYear() has not added
+        UnionFind sets; // sets of actors connected by the movies ufindByYear() added
+        string key_buf; // scratch buffer for building title#@year keys
+        vector<pair<uint32_t, uint32_t>> rows; // (movie, actor) read but not in a cast yet
+        unique_ptr<ThreadPool> pool;
+        WeightMode weight_mode;
+        MappedFile snapshot_file; // backs the arrays of a loaded snapshot
+        Arena arena; // backs the casts and the adjacency built in memory
+        LoadStats load_stats; // of the last loadFromStream()
+
+        void mergeShard(const LoadShard& shard);
+
+        void packCasts();
+
+        uint32_t internName(string_view name);
+
+        uint32_t internMovie(string_view fmt_title, int year);
+
+        uint32_t internActor(string_view actor_name);
+
+        void addRecord(string_view actor_name, string_view movie_title,
+                       string_view movie_year);
 
     public:
         ActorGraph(void);
 
         ~ActorGraph();
 
+        void setThreads(unsigned num_threads);
+
+        unsigned numThreads() const { return pool->size(); }
+
+        ThreadPool& threads() { return *pool; }
+
         bool loadFromFile(const char* in_filename, bool use_weighted_edges);
 
+        bool loadFromStream(istream& in, bool use_weighted_edges);
+
+        const LoadStats& loadStats() const { return load_stats; }
+
+        bool loadFromMappedFile(const char* in_filename, bool use_weighted_edges);
+
+        bool saveSnapshot(const char* out_filename) const;
+
+        bool loadSnapshot(const char* in_filename);
+
+        WeightMode weightMode() const { return weight_mode; }
+
+        bool hasClique() const { return csr.numNodes() == actors.size() && !actors.empty(); }
+
+        bool hasCompressed() const { return packed.built(); }
+
+        bool hasBipartite() const { return incidence_lists.built(); }
+
         int neighborSize(string actor_name);
 
         void build();
 
-        ActorNode* getActor(string actor_name);
+        const CsrGraph& adjacency() const { return csr; }
+
+        void buildCompressed();
+
+        const CompressedGraph& compressed() const { return packed; }
+
+        void buildBipartite();
+
+        const BipartiteGraph& incidence() const { return incidence_lists; }
+
+        void buildConnections();
+
+        const ConnectionIndex& connectionIndex() const { return connections; }
+
+        void buildLandmarks(uint32_t count);
+
+        const Landmarks& landmarkTable() const { return landmarks; }
+
+        vector<uint32_t> reorder(NodeOrdering how);
+
+        uint32_t getActor(string_view actor_name) const;
+
+        ActorNode& getNode(uint32_t actor) { return actors[actor]; }
+
+        const Movie& getMovie(uint32_t movie) const { return movies[movie]; }
+
+        uint32_t numActors() const { return actors.size(); }
+
+        uint32_t numMovies() const { return movies.size(); }
+
+        void initWorkspace(SearchWorkspace& ws) const;
+
+        string_view actorName(uint32_t actor) const { return names.get(actors[actor].name); }
+
+        string_view movieName(uint32_t movie) const { return names.get(movies[movie].name); }
 
         void resetNodes();
 
         void useWeights();
 
-        void sortMovies();
+        void useYears();
 
-        bool buildByYear();
+        vector<int> movieYears() const;
 
-        int curr_year;
+        int minWeight() const;
 
-        void resetNeighbors();
+        int maxWeight() const;
+
+        void sortMovies();
+
+        int curr_year;
 
         bool ufindByYear();
+
+        uint32_t findSet(uint32_t actor) { return sets.find(actor); }
 };
 
 
@@ -2,34 +2,29 @@
  * File: ActorNode.h
  * Date: December 4, 2017  
  * Purpose: This file defines all the methods used to define the actor nodes  
- *      that implements actors and assigns their neighbors, size,
- *      and sorts them by distance in a priority queue */
+ *      that implements actors.  Their co-stars live in the CsrGraph, the state of
+ *      path searches lives in a SearchWorkspace and the ufind sets in a
+ *      UnionFind instead.  Actors, movies and names are all referred to by
+ *      dense uint32_t ids owned by ActorGraph */
 
 #ifndef ACTORNODE_H
 #define ACTORNODE_H
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <limits.h>
-#include <unordered_map>
+#include <limits>
 using namespace std;
 
+// id used for "no actor" / "no movie", e.g. the prev of the start node
+const uint32_t NO_ID = numeric_limits<uint32_t>::max();
+
 class ActorNode
 {
 	private:
 
 	public:
-		ActorNode(string name);
-		vector<ActorNode*> neighbors;
-		int dist;
-		ActorNode* prev;
-		bool done;
-		void addNeighbor(ActorNode* actor, string fmt_title, int weight);
-		int neighborSize();
-		unordered_map<ActorNode*, pair<string, int>> edge_map;
-		string name;
-        int size;
-        ActorNode* parent;
-
-        bool operator<(const ActorNode& other);
+		ActorNode(uint32_t name);
+		uint32_t name; // id of the name in the graph's string table
 };
 #endif
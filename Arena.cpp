@@ -0,0 +1,97 @@
+/*
+ * File: Arena.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements the bump allocator.  Requests larger than a quarter
+ *      of a chunk get a mapping of their own so they never waste the rest of
+ *      the shared chunk.
+ */
+
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "Arena.h"
+
+using namespace std;
+
+// Constructor, nothing is mapped before the first allocation
+Arena::Arena(size_t chunk_size) : next(nullptr), left(0), chunk_size(chunk_size), used(0) {}
+
+Arena::~Arena() {
+    release();
+}
+
+/* Maps size bytes of zeroed memory and remembers the mapping.  Sizes of a
+ * huge page or more are rounded up to whole huge pages and aligned to one so
+ * the kernel can back them with huge pages.  Throws bad_alloc like new.
+ */
+char* Arena::map(size_t size) {
+    size_t page = sysconf(_SC_PAGESIZE);
+    size_t align = size >= HUGE_PAGE ? HUGE_PAGE : page;
+    size = (size + align - 1) / align * align;
+
+    size_t map_size = align > page ? size + align : size;
+    void* addr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(addr == MAP_FAILED) throw bad_alloc();
+
+    char* base = static_cast<char*>(addr);
+    if(map_size != size) {
+        // give back what is before the first and after the last huge page
+        char* aligned = reinterpret_cast<char*>(
+            (reinterpret_cast<uintptr_t>(base) + align - 1) / align * align);
+        if(aligned != base) munmap(base, aligned - base);
+        char* tail = aligned + size;
+        if(tail != base + map_size) munmap(tail, base + map_size - tail);
+        base = aligned;
+#ifdef MADV_HUGEPAGE
+        madvise(base, size, MADV_HUGEPAGE);
+#endif
+    }
+
+    chunks.push_back(Chunk{base, size});
+    return base;
+}
+
+/* Returns bytes of zeroed memory aligned to align, a power of two no larger
+ * than a page.  The memory stays valid until release().
+ */
+void* Arena::allocate(size_t bytes, size_t align) {
+    size_t pad = (align - reinterpret_cast<uintptr_t>(next) % align) % align;
+
+    if(pad + bytes > left) {
+        if(bytes > chunk_size / 4) {
+            used += bytes;
+            return map(bytes);
+        }
+        next = map(chunk_size);
+        left = chunks.back().size;
+        pad = 0;
+    }
+
+    char* result = next + pad;
+    next += pad + bytes;
+    left -= pad + bytes;
+    used += bytes;
+    return result;
+}
+
+// Unmaps every chunk at once, everything allocated so far becomes invalid.
+void Arena::release() {
+    for(auto& c: chunks) {
+        munmap(c.base, c.size);
+    }
+    chunks.clear();
+    next = nullptr;
+    left = 0;
+    used = 0;
+}
+
+// Returns how much memory the chunks take, including what is still free.
+size_t Arena::bytesMapped() const {
+    size_t total = 0;
+    for(auto& c: chunks) {
+        total += c.size;
+    }
+    return total;
+}
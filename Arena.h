@@ -0,0 +1,58 @@
+/*
+ * File: Arena.h
+ * Date: December 4, 2017
+ * Purpose: Declares the bump allocator that holds the casts and the
+ *      adjacency of a graph built in memory.  Memory is handed out from a few
+ *      large anonymous mappings and is only given back all at once, so the
+ *      graph is made of a handful of allocations instead of one per movie or
+ *      actor and tearing it down is a few munmap calls.  On Linux chunks of a
+ *      huge page or more are aligned to and advised for huge pages.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+class Arena
+{
+    private:
+        struct Chunk
+        {
+            char* base;
+            size_t size;
+        };
+
+        vector<Chunk> chunks;
+        char* next;        // first free byte of the current chunk
+        size_t left;       // free bytes after next
+        size_t chunk_size; // size of the chunks small requests share
+        size_t used;
+
+        char* map(size_t size);
+
+    public:
+        static const size_t HUGE_PAGE = 2 << 20;
+
+        Arena(size_t chunk_size = 1 << 20);
+
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(size_t bytes, size_t align);
+
+        // Uninitialized room for n objects of T, valid until release().
+        template<class T>
+        T* allocate(size_t n) { return static_cast<T*>(allocate(n * sizeof(T), alignof(T))); }
+
+        void release();
+
+        size_t bytesUsed() const { return used; }
+
+        size_t bytesMapped() const;
+};
+#endif
@@ -0,0 +1,67 @@
+/* 
+ * File: BipartiteGraph.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the construction of the actor <-> movie incidence
+ *      lists from the movie casts.
+ */
+
+#include <algorithm>
+#include "BipartiteGraph.h"
+
+using namespace std;
+
+/* Copies the casts into one flat array and builds the reverse lists by a
+ * counting sort, so the movies of every actor come out in increasing id.
+ */
+void BipartiteGraph::build(const vector<Movie>& movies, uint32_t num_actors) {
+    movie_offsets.assign(movies.size() + 1, 0);
+    movie_weights.resize(movies.size());
+    actor_offsets.assign(num_actors + 1, 0);
+
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        movie_offsets[m + 1] = movie_offsets[m] + movies[m].getCast().size();
+        movie_weights[m] = movies[m].getWeight();
+        for(uint32_t a: movies[m].getCast()) {
+            actor_offsets[a + 1]++;
+        }
+    }
+
+    for(uint32_t a = 0; a < num_actors; a++) {
+        actor_offsets[a + 1] += actor_offsets[a];
+    }
+
+    movie_cast.resize(movie_offsets[movies.size()]);
+    actor_movies.resize(actor_offsets[num_actors]);
+    vector<uint64_t> next_slot(actor_offsets.begin(), actor_offsets.end() - 1);
+
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        uint64_t slot = movie_offsets[m];
+        for(uint32_t a: movies[m].getCast()) {
+            movie_cast[slot++] = a;
+            actor_movies[next_slot[a]++] = m;
+        }
+    }
+}
+
+/* Adds the actor side of the incidence lists to a snapshot.  The movie side
+ * is the same as the casts and weights the graph stores for every movie.
+ */
+void BipartiteGraph::save(SnapshotWriter& out) const {
+    out.add(SNAP_BIP_ACTOR_OFFSETS, actor_offsets);
+    out.add(SNAP_BIP_ACTOR_MOVIES, actor_movies);
+}
+
+/* Uses the incidence lists stored in a snapshot in place.  Returns false if
+ * they are missing or do not fit together.
+ */
+bool BipartiteGraph::load(const SnapshotReader& in) {
+    if(!in.get(SNAP_BIP_ACTOR_OFFSETS, actor_offsets) || !in.get(SNAP_BIP_ACTOR_MOVIES, actor_movies) ||
+       !in.get(SNAP_CAST_OFFSETS, movie_offsets) || !in.get(SNAP_CAST_ACTORS, movie_cast) ||
+       !in.get(SNAP_MOVIE_WEIGHTS, movie_weights)) {
+        return false;
+    }
+
+    return !actor_offsets.empty() && actor_offsets.back() == actor_movies.size() &&
+           movie_offsets.size() == movie_weights.size() + 1 &&
+           movie_offsets.back() == movie_cast.size();
+}
@@ -0,0 +1,57 @@
+/* 
+ * File: BipartiteGraph.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the actor <-> movie incidence lists of the graph.  Instead
+ *      of materializing a clique for every cast, the searches step from an
+ *      actor to its movies and from a movie to its cast, and expand every
+ *      movie at most once per search.
+ */
+
+#ifndef BIPARTITEGRAPH_H
+#define BIPARTITEGRAPH_H
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "FlatArray.h"
+#include "Movie.h"
+#include "SearchWorkspace.h"
+#include "SnapshotFile.h"
+using namespace std;
+
+class BipartiteGraph
+{
+    public:
+        FlatArray<uint64_t> actor_offsets; // movies of actor a are actor_movies[actor_offsets[a] ..]
+        FlatArray<uint32_t> actor_movies;  // in increasing movie id
+        FlatArray<uint64_t> movie_offsets; // cast of movie m is movie_cast[movie_offsets[m] ..]
+        FlatArray<uint32_t> movie_cast;
+        FlatArray<int> movie_weights;
+
+        void build(const vector<Movie>& movies, uint32_t num_actors);
+
+        bool built() const { return !actor_offsets.empty(); }
+
+        void save(SnapshotWriter& out) const;
+
+        bool load(const SnapshotReader& in);
+
+        uint32_t numNodes() const { return actor_offsets.empty() ? 0 : actor_offsets.size() - 1; }
+
+        /* Calls f(co_star, weight, movie) for every co-star reached through a
+         * movie of actor that the search of ws has not expanded yet.  Movies
+         * heavier than max_weight are skipped (and stay unexpanded).
+         */
+        template<class F>
+        void forEachEdge(uint32_t actor, SearchWorkspace& ws, F f, int max_weight = INT_MAX) const {
+            for(uint64_t i = actor_offsets[actor]; i < actor_offsets[actor + 1]; i++) {
+                uint32_t movie = actor_movies[i];
+                int weight = movie_weights[movie];
+                if(weight > max_weight || !ws.expandMovie(movie)) continue;
+
+                for(uint64_t j = movie_offsets[movie]; j < movie_offsets[movie + 1]; j++) {
+                    f(movie_cast[j], weight, movie);
+                }
+            }
+        }
+};
+#endif
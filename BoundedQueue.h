@@ -0,0 +1,65 @@
+/*
+ * File: BoundedQueue.h
+ * Date: December 4, 2017
+ * Purpose: Declares the blocking queue that connects the stages of the
+ *      stream loader.  push() waits while the queue is full, so a fast
+ *      stage cannot run ahead of a slow one and hold the whole file in
+ *      memory, and pop() waits while it is empty.  close() ends the stream:
+ *      pops drain what is left and then fail, pushes fail at once.
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+using namespace std;
+
+template<class T>
+class BoundedQueue
+{
+    private:
+        mutex lock;
+        condition_variable not_empty;
+        condition_variable not_full;
+        deque<T> items;
+        size_t capacity;
+        bool closed;
+
+    public:
+        BoundedQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // Waits for room and appends item, returns false if the queue was closed.
+        bool push(T item) {
+            unique_lock<mutex> guard(lock);
+            not_full.wait(guard, [&] { return closed || items.size() < capacity; });
+            if(closed) return false;
+            items.push_back(move(item));
+            not_empty.notify_one();
+            return true;
+        }
+
+        // Waits for an item and takes it, returns false once closed and empty.
+        bool pop(T& item) {
+            unique_lock<mutex> guard(lock);
+            not_empty.wait(guard, [&] { return closed || !items.empty(); });
+            if(items.empty()) return false;
+            item = move(items.front());
+            items.pop_front();
+            not_full.notify_one();
+            return true;
+        }
+
+        void close() {
+            lock_guard<mutex> guard(lock);
+            closed = true;
+            not_empty.notify_all();
+            not_full.notify_all();
+        }
+};
+#endif
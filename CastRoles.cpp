@@ -0,0 +1,120 @@
+/*
+ * File: CastRoles.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements sorting out the roles of the actors and walking the
+ *      co-stars of an actor through them.
+ */
+
+#include <algorithm>
+#include "ActorNode.h"
+#include "CastRoles.h"
+
+using namespace std;
+
+/* Lists the (movie, first place in the cast) of every actor, movies in
+ * increasing id, and how many cast slots the co-stars of every actor take
+ * to walk.
+ */
+CastRoles::CastRoles(const vector<Movie>& movies, uint32_t num_actors)
+    : movies(movies.data()), roles_begin(num_actors + 1, 0), work(num_actors + 1, 0) {
+    vector<uint32_t> last_movie(num_actors, NO_ID);
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        for(uint32_t a: movies[m].getCast()) {
+            if(last_movie[a] != m) roles_begin[a + 1]++;
+            last_movie[a] = m;
+        }
+    }
+    for(uint32_t a = 0; a < num_actors; a++) {
+        roles_begin[a + 1] += roles_begin[a];
+    }
+
+    role_movies.resize(roles_begin[num_actors]);
+    role_places.resize(roles_begin[num_actors]);
+    vector<uint64_t> next_role(roles_begin.begin(), roles_begin.end() - 1);
+    fill(last_movie.begin(), last_movie.end(), NO_ID);
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        const FlatArray<uint32_t>& cast = movies[m].getCast();
+        for(uint32_t i = 0; i < cast.size(); i++) {
+            uint32_t a = cast[i];
+            if(last_movie[a] == m) continue; // only the first place counts
+            last_movie[a] = m;
+            role_movies[next_role[a]] = m;
+            role_places[next_role[a]++] = i;
+            work[a + 1] += cast.size();
+        }
+    }
+    for(uint32_t a = 0; a < num_actors; a++) {
+        work[a + 1] += work[a];
+    }
+}
+
+/* Splits the actors into num_ranges ranges of about the same work, range r
+ * is [result[r], result[r + 1]).
+ */
+vector<uint32_t> CastRoles::split(size_t num_ranges) const {
+    uint32_t num_actors = numActors();
+    vector<uint32_t> range_begin(num_ranges + 1, num_actors);
+    range_begin[0] = 0;
+    for(size_t r = 1; r < num_ranges; r++) {
+        uint64_t target = work[num_actors] / num_ranges * r;
+        range_begin[r] = lower_bound(work.begin(), work.end() - 1, target) - work.begin();
+    }
+    return range_begin;
+}
+
+/* Counts the distinct co-stars of actor.  owner is scratch of one thread,
+ * owner[b] == actor marks b as counted.  The arrays are read through local
+ * pointers, stores to owner could otherwise alias them and force reloads.
+ */
+uint64_t CastRoles::countCoStars(uint32_t actor, uint32_t* owner) const {
+    const Movie* movie_data = movies;
+    const uint32_t* role_movie = role_movies.data();
+    const uint32_t* role_place = role_places.data();
+    uint64_t degree = 0;
+    for(uint64_t k = roles_begin[actor], last = roles_begin[actor + 1]; k < last; k++) {
+        const FlatArray<uint32_t>& cast = movie_data[role_movie[k]].getCast();
+        uint32_t place = role_place[k];
+        for(uint32_t i = 0; i < cast.size(); i++) {
+            if(i != place && owner[cast[i]] != actor) {
+                owner[cast[i]] = actor;
+                degree++;
+            }
+        }
+    }
+    return degree;
+}
+
+/* Writes the edges of actor from slot end on, keeping the lightest movie of
+ * every co-star and the lower movie id among equally light ones, and returns
+ * the slot after the last edge.  owner and slot are scratch of one thread,
+ * slot[b] is the edge to b once owner[b] == actor.
+ */
+uint64_t CastRoles::linkCoStars(uint32_t actor, uint64_t end, uint32_t* owner, uint64_t* slot,
+                                uint32_t* targets, int* weights, uint32_t* movie_ids) const {
+    const Movie* movie_data = movies;
+    const uint32_t* role_movie = role_movies.data();
+    const uint32_t* role_place = role_places.data();
+    for(uint64_t k = roles_begin[actor], last = roles_begin[actor + 1]; k < last; k++) {
+        uint32_t m = role_movie[k];
+        const FlatArray<uint32_t>& cast = movie_data[m].getCast();
+        int weight = movie_data[m].getWeight();
+        uint32_t place = role_place[k];
+        for(uint32_t i = 0; i < cast.size(); i++) {
+            uint32_t b = cast[i];
+            if(i == place) continue;
+            if(owner[b] != actor) {
+                owner[b] = actor;
+                slot[b] = end;
+                targets[end] = b;
+                weights[end] = weight;
+                movie_ids[end++] = m;
+            }
+            else if(weight < weights[slot[b]]) {
+                // a lighter movie connects the two actors, use that instead
+                weights[slot[b]] = weight;
+                movie_ids[slot[b]] = m;
+            }
+        }
+    }
+    return end;
+}
@@ -0,0 +1,42 @@
+/*
+ * File: CastRoles.h
+ * Date: December 4, 2017
+ * Purpose: Declares the roles of every actor: the movies an actor plays in
+ *      and the first place it takes in each cast, grouped by actor.  The
+ *      adjacency builders walk the casts of an actor through them to find
+ *      its co-stars, actor by actor and in ranges on several threads,
+ *      without ever materializing the edges of all actors at once.
+ */
+
+#ifndef CASTROLES_H
+#define CASTROLES_H
+#include <cstdint>
+#include <vector>
+#include "Movie.h"
+using namespace std;
+
+class CastRoles
+{
+    private:
+        const Movie* movies;
+        vector<uint64_t> roles_begin; // roles of actor a are [roles_begin[a], roles_begin[a + 1])
+        vector<uint32_t> role_movies; // in increasing movie id
+        vector<uint32_t> role_places;
+        vector<uint64_t> work;        // cast slots looked at up to each actor
+
+    public:
+        CastRoles(const vector<Movie>& movies, uint32_t num_actors);
+
+        uint32_t numActors() const { return roles_begin.size() - 1; }
+
+        // cast slots walked for actor, a bound on its number of co-stars
+        uint64_t castSlots(uint32_t actor) const { return work[actor + 1] - work[actor]; }
+
+        vector<uint32_t> split(size_t num_ranges) const;
+
+        uint64_t countCoStars(uint32_t actor, uint32_t* owner) const;
+
+        uint64_t linkCoStars(uint32_t actor, uint64_t end, uint32_t* owner, uint64_t* slot,
+                             uint32_t* targets, int* weights, uint32_t* movie_ids) const;
+};
+#endif
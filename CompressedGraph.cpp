@@ -0,0 +1,194 @@
+/*
+ * File: CompressedGraph.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements encoding the clique adjacency straight from the casts
+ *      into varint gaps and packed movie ids.
+ */
+
+#include <algorithm>
+#include "ActorNode.h"
+#include "CastRoles.h"
+#include "CompressedGraph.h"
+
+using namespace std;
+
+/* Scratch of one thread: the CastRoles::linkCoStars() marks and the edges of
+ * the actor being encoded, as (neighbor << 32 | movie) once sorted.
+ */
+struct EncodeScratch
+{
+    vector<uint32_t> owner;
+    vector<uint64_t> slot;
+    vector<uint32_t> targets;
+    vector<int> weights;
+    vector<uint32_t> movies;
+    vector<uint64_t> edges;
+};
+
+// Returns how many bytes the varint of value takes.
+static uint32_t varintSize(uint64_t value) {
+    uint32_t size = 1;
+    while(value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+// Writes the varint of value at p and moves p past it.
+static void writeVarint(uint8_t*& p, uint64_t value) {
+    while(value >= 0x80) {
+        *p++ = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(value);
+}
+
+// Returns the gap stored for the first co-star of node, zigzag encoded.
+static uint64_t firstGap(uint32_t node, uint32_t neighbor) {
+    int64_t delta = static_cast<int64_t>(neighbor) - node;
+    return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+}
+
+/* Finds the co-stars of actor with their lightest movie, the same edges
+ * CsrGraph::build() gives, and leaves them sorted by neighbor in
+ * scratch.edges.  Returns how many there are.
+ */
+static uint32_t sortedCoStars(const CastRoles& roles, uint32_t actor, EncodeScratch& scratch) {
+    uint64_t bound = min<uint64_t>(roles.castSlots(actor), roles.numActors());
+    if(scratch.targets.size() < bound) {
+        scratch.targets.resize(bound);
+        scratch.weights.resize(bound);
+        scratch.movies.resize(bound);
+        scratch.edges.resize(bound);
+    }
+
+    uint32_t degree = roles.linkCoStars(actor, 0, scratch.owner.data(), scratch.slot.data(),
+                                        scratch.targets.data(), scratch.weights.data(),
+                                        scratch.movies.data());
+    uint64_t* edges = scratch.edges.data();
+    for(uint32_t i = 0; i < degree; i++) {
+        edges[i] = static_cast<uint64_t>(scratch.targets[i]) << 32 | scratch.movies[i];
+    }
+    sort(edges, edges + degree);
+    return degree;
+}
+
+/* ORs value into word w of words.  The first and last word of a range may be
+ * shared with the ranges next to it and are written atomically.
+ */
+static void orWord(uint64_t* words, uint64_t w, uint64_t value, uint64_t first_word,
+                   uint64_t last_word) {
+    if(value == 0) return;
+    if(w == first_word || w == last_word) {
+        __atomic_fetch_or(&words[w], value, __ATOMIC_RELAXED);
+    }
+    else {
+        words[w] |= value;
+    }
+}
+
+/* Encodes the same edges as CsrGraph::build(), every co-star once with the
+ * lightest movie the two actors share.  A first pass over ranges of actors
+ * on pool finds every actor's co-stars, sorts them and sizes its gaps; a
+ * second pass finds them again and writes them into arrays of the exact
+ * size, so the uncompressed edges of all actors never exist at once.
+ */
+void CompressedGraph::build(const vector<Movie>& movies, uint32_t num_actors, Arena& arena,
+                            ThreadPool& pool) {
+    CastRoles roles(movies, num_actors);
+    size_t num_ranges = pool.size() == 1 ? 1 : pool.size() * 16;
+    vector<uint32_t> range_begin = roles.split(num_ranges);
+
+    movie_width = 1;
+    while(movie_width < 32 && (uint64_t(1) << movie_width) < movies.size()) {
+        movie_width++;
+    }
+    movie_mask = (uint64_t(1) << movie_width) - 1;
+    movie_weights.resize(movies.size());
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        movie_weights[m] = movies[m].getWeight();
+    }
+
+    vector<EncodeScratch> scratches(pool.size());
+    uint64_t* byte_data = arena.allocate<uint64_t>(num_actors + 1);
+    uint64_t* edge_data = arena.allocate<uint64_t>(num_actors + 1);
+    byte_data[0] = 0;
+    edge_data[0] = 0;
+
+    auto prepare = [&](unsigned worker) {
+        EncodeScratch& scratch = scratches[worker];
+        if(scratch.owner.empty()) {
+            scratch.owner.assign(num_actors, NO_ID);
+            scratch.slot.resize(num_actors);
+        }
+        return &scratch;
+    };
+
+    pool.parallelFor(num_ranges, [&](size_t r, unsigned worker) {
+        EncodeScratch& scratch = *prepare(worker);
+        for(uint32_t a = range_begin[r]; a < range_begin[r + 1]; a++) {
+            uint32_t degree = sortedCoStars(roles, a, scratch);
+            const uint64_t* edges = scratch.edges.data();
+            uint64_t size = 0;
+            for(uint32_t i = 0; i < degree; i++) {
+                uint32_t b = edges[i] >> 32;
+                size += varintSize(i == 0 ? firstGap(a, b) : b - (edges[i - 1] >> 32) - 1);
+            }
+            byte_data[a + 1] = size;
+            edge_data[a + 1] = degree;
+        }
+    });
+    for(uint32_t a = 0; a < num_actors; a++) {
+        byte_data[a + 1] += byte_data[a];
+        edge_data[a + 1] += edge_data[a];
+    }
+
+    uint64_t num_bytes = byte_data[num_actors];
+    uint64_t num_words = (edge_data[num_actors] * movie_width + 63) / 64 + 1;
+    uint8_t* gap_data = arena.allocate<uint8_t>(num_bytes + 1); // zeroed padding for readVarint()
+    uint64_t* word_data = arena.allocate<uint64_t>(num_words); // zeroed by the arena
+    for(auto& scratch: scratches) {
+        fill(scratch.owner.begin(), scratch.owner.end(), NO_ID);
+    }
+
+    uint32_t width = movie_width;
+    pool.parallelFor(num_ranges, [&](size_t r, unsigned worker) {
+        EncodeScratch& scratch = *prepare(worker);
+        uint32_t first = range_begin[r];
+        uint32_t end = range_begin[r + 1];
+        if(edge_data[first] == edge_data[end]) return;
+        uint64_t first_word = edge_data[first] * width / 64;
+        uint64_t last_word = (edge_data[end] * width - 1) / 64;
+
+        for(uint32_t a = first; a < end; a++) {
+            uint32_t degree = sortedCoStars(roles, a, scratch);
+            const uint64_t* edges = scratch.edges.data();
+            uint8_t* p = gap_data + byte_data[a];
+            uint64_t bit = edge_data[a] * width;
+            for(uint32_t i = 0; i < degree; i++, bit += width) {
+                uint32_t b = edges[i] >> 32;
+                writeVarint(p, i == 0 ? firstGap(a, b) : b - (edges[i - 1] >> 32) - 1);
+
+                uint64_t movie = static_cast<uint32_t>(edges[i]);
+                uint64_t w = bit / 64;
+                unsigned shift = bit % 64;
+                orWord(word_data, w, movie << shift, first_word, last_word);
+                if(shift + width > 64) {
+                    orWord(word_data, w + 1, movie >> (64 - shift), first_word, last_word);
+                }
+            }
+        }
+    });
+
+    byte_offsets.view(byte_data, num_actors + 1);
+    edge_offsets.view(edge_data, num_actors + 1);
+    bytes.view(gap_data, num_bytes);
+    movie_bits.view(word_data, num_words);
+}
+
+// Returns the bytes the adjacency takes, offsets and weights included.
+size_t CompressedGraph::memoryBytes() const {
+    return byte_offsets.size() * sizeof(uint64_t) + edge_offsets.size() * sizeof(uint64_t) +
+           bytes.size() + movie_bits.size() * sizeof(uint64_t) + movie_weights.size() * sizeof(int);
+}
@@ -0,0 +1,113 @@
+/*
+ * File: CompressedGraph.h
+ * Date: December 4, 2017
+ * Purpose: Declares a compressed copy of the clique adjacency for casts too
+ *      large to hold as CsrGraph.  The co-stars of an actor are sorted by id
+ *      and stored as varint gaps: the first one relative to the actor
+ *      itself, zigzag encoded, every later one as the distance to the one
+ *      before minus one, seven bits a byte with the high bit set on all but
+ *      the last byte.  Actors renumbered close to their co-stars (see
+ *      NodeOrder.h) mostly need one or two bytes an edge.  The movie of
+ *      every edge is packed into movieWidth() bits of a side array and the
+ *      weight is looked up by movie, so an edge takes about a third of the
+ *      twelve bytes CsrGraph needs.  forEachEdge() decodes in place, the
+ *      searches walk it like the other adjacencies.
+ */
+
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "Arena.h"
+#include "FlatArray.h"
+#include "Movie.h"
+#include "SearchWorkspace.h"
+#include "ThreadPool.h"
+using namespace std;
+
+class CompressedGraph
+{
+    private:
+        uint32_t movie_width; // bits of every packed movie id
+        uint64_t movie_mask;
+
+    public:
+        FlatArray<uint64_t> byte_offsets; // gaps of actor a start at bytes[byte_offsets[a]]
+        FlatArray<uint64_t> edge_offsets; // edges of actor a are [edge_offsets[a], edge_offsets[a+1])
+        FlatArray<uint8_t> bytes;         // varint gaps of the co-stars, one byte of padding
+        FlatArray<uint64_t> movie_bits;   // movie of edge e at bit e * movieWidth(), one word of padding
+        FlatArray<int> movie_weights;     // weight of every movie when built
+
+        CompressedGraph(void) : movie_width(1), movie_mask(1) {}
+
+        void build(const vector<Movie>& movies, uint32_t num_actors, Arena& arena,
+                   ThreadPool& pool);
+
+        bool built() const { return !edge_offsets.empty(); }
+
+        uint32_t numNodes() const { return edge_offsets.empty() ? 0 : edge_offsets.size() - 1; }
+
+        uint64_t numEdges() const { return edge_offsets.empty() ? 0 : edge_offsets.back(); }
+
+        uint32_t degree(uint32_t node) const { return edge_offsets[node + 1] - edge_offsets[node]; }
+
+        uint32_t movieWidth() const { return movie_width; }
+
+        size_t memoryBytes() const;
+
+        // Calls f(neighbor, weight, movie) for every edge of node not heavier
+        // than max_weight, neighbors in increasing id.  Like CsrGraph there is
+        // no per-search state, ws is only taken to match the other graphs.
+        template<class F>
+        void forEachEdge(uint32_t node, SearchWorkspace&, F f, int max_weight = INT_MAX) const {
+            uint64_t e = edge_offsets[node];
+            uint64_t last = edge_offsets[node + 1];
+            if(e == last) return;
+
+            const uint8_t* p = bytes.data() + byte_offsets[node];
+            const uint64_t* words = movie_bits.data();
+            const int* weight_of = movie_weights.data();
+            uint32_t width = movie_width;
+            uint64_t mask = movie_mask;
+            uint64_t bit = e * width;
+
+            uint64_t gap = readVarint(p);
+            uint32_t neighbor = node + static_cast<uint32_t>((gap >> 1) ^ (0 - (gap & 1)));
+            for(;;) {
+                uint64_t w = bit >> 6;
+                unsigned shift = bit & 63;
+                // the second half is 0 when the id fits the first word
+                uint32_t movie = ((words[w] >> shift) | ((words[w + 1] << 1) << (63 - shift))) & mask;
+                int weight = weight_of[movie];
+                if(weight <= max_weight) {
+                    f(neighbor, weight, movie);
+                }
+
+                if(++e == last) break;
+                bit += width;
+                neighbor += static_cast<uint32_t>(readVarint(p)) + 1;
+            }
+        }
+
+        // Decodes the varint at p and moves p past it.  Gaps of one and two
+        // bytes, nearly all of them, are decoded without a branch on the
+        // length, bytes is padded so p[1] can always be read.
+        static uint64_t readVarint(const uint8_t*& p) {
+            uint64_t two = p[0] | uint64_t(p[1]) << 8;
+            uint64_t more = (two >> 7) & 1;
+            if(__builtin_expect(more & (two >> 15), 0)) return readLongVarint(p);
+            p += 1 + more;
+            return (two & 0x7f) | ((two >> 1) & 0x3f80 & (0 - more));
+        }
+
+        static uint64_t readLongVarint(const uint8_t*& p) {
+            uint64_t value = 0;
+            for(unsigned shift = 0; ; shift += 7) {
+                uint64_t byte = *p++;
+                value |= (byte & 0x7f) << shift;
+                if(byte < 0x80) return value;
+            }
+        }
+};
+#endif
@@ -0,0 +1,92 @@
+/* 
+ * File: ConnectionIndex.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the construction and the queries of the connection
+ *      year index.
+ */
+
+#include <algorithm>
+#include <climits>
+#include "ConnectionIndex.h"
+
+using namespace std;
+
+// Constructor, the index is empty until build() or load()
+ConnectionIndex::ConnectionIndex(void) : first_year(NEVER) {}
+
+/* Adds the movies in order of year, k - 1 merges of the first cast member
+ * with the others for a cast of k, and records the year of every merge in
+ * the actor that went under the other.
+ */
+void ConnectionIndex::build(const vector<Movie>& movies, uint32_t num_actors) {
+    vector<uint32_t> order(movies.size());
+    for(uint32_t m = 0; m < movies.size(); m++) {
+        order[m] = m;
+    }
+    stable_sort(order.begin(), order.end(),
+                [&](uint32_t a, uint32_t b) { return movies[a].year < movies[b].year; });
+
+    parent.assign(num_actors, NO_ID);
+    years.assign(num_actors, INT_MAX);
+    vector<uint32_t> sizes(num_actors, 1);
+    first_year = order.empty() ? NEVER : movies[order[0]].year;
+
+    auto find = [&](uint32_t x) {
+        while(parent[x] != NO_ID) x = parent[x];
+        return x;
+    };
+
+    for(uint32_t m: order) {
+        const FlatArray<uint32_t>& cast = movies[m].getCast();
+        for(size_t i = 1; i < cast.size(); i++) {
+            uint32_t a = find(cast[0]);
+            uint32_t b = find(cast[i]);
+            if(a == b) continue;
+
+            if(sizes[a] < sizes[b]) swap(a, b);
+            parent[b] = a;
+            years[b] = movies[m].year;
+            sizes[a] += sizes[b];
+        }
+    }
+}
+
+/* Returns the first year in which a and b are connected, NEVER if they never
+ * are.  An actor is connected to itself from the year of the earliest movie,
+ * as replaying the years with ufindByYear() says.
+ */
+int ConnectionIndex::connectedYear(uint32_t a, uint32_t b) const {
+    if(a == b) return first_year;
+
+    int year = NEVER;
+    while(a != b) {
+        // the side that got its parent earlier climbs first, the last year
+        // climbed before the two meet is the largest on the path
+        if(years[a] > years[b]) swap(a, b);
+        if(years[a] == INT_MAX) return NEVER; // two different sentinels
+
+        year = years[a];
+        a = parent[a];
+    }
+    return year;
+}
+
+// Adds the index to a snapshot.
+void ConnectionIndex::save(SnapshotWriter& out) const {
+    out.add(SNAP_CONN_PARENTS, parent);
+    out.add(SNAP_CONN_YEARS, years);
+    out.add(SNAP_CONN_FIRST_YEAR, &first_year, 1);
+}
+
+/* Uses the index stored in a snapshot in place.  Returns false if it is
+ * missing or does not fit together.
+ */
+bool ConnectionIndex::load(const SnapshotReader& in) {
+    FlatArray<int> first;
+    if(!in.get(SNAP_CONN_PARENTS, parent) || !in.get(SNAP_CONN_YEARS, years) ||
+       !in.get(SNAP_CONN_FIRST_YEAR, first) || first.size() != 1) {
+        return false;
+    }
+    first_year = first[0];
+    return parent.size() == years.size();
+}
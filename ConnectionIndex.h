@@ -0,0 +1,45 @@
+/* 
+ * File: ConnectionIndex.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the index of the year every pair of actors becomes
+ *      connected.  It is the union-find of adding the movies year by year,
+ *      kept without path compression: merging by size keeps every tree
+ *      O(log n) deep, and every actor remembers the year it was put under
+ *      its parent.  Two actors are connected from the largest year on the
+ *      tree path between them, which a query finds by climbing from both.
+ */
+
+#ifndef CONNECTIONINDEX_H
+#define CONNECTIONINDEX_H
+#include <cstdint>
+#include <vector>
+#include "FlatArray.h"
+#include "Movie.h"
+#include "SnapshotFile.h"
+using namespace std;
+
+class ConnectionIndex
+{
+    private:
+        FlatArray<uint32_t> parent; // NO_ID for a sentinel
+        FlatArray<int> years;       // year an actor was put under its parent, INT_MAX for sentinels
+        int first_year;             // year of the earliest movie
+
+    public:
+        static constexpr int NEVER = 9999; // year of actors that never become connected
+
+        ConnectionIndex(void);
+
+        void build(const vector<Movie>& movies, uint32_t num_actors);
+
+        bool built() const { return !years.empty(); }
+
+        uint32_t numActors() const { return years.size(); }
+
+        int connectedYear(uint32_t a, uint32_t b) const;
+
+        void save(SnapshotWriter& out) const;
+
+        bool load(const SnapshotReader& in);
+};
+#endif
@@ -0,0 +1,131 @@
+/* 
+ * File: CsrGraph.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements building the compressed sparse row arrays from the
+ *      movie casts.
+ */
+
+#include <algorithm>
+#include "CastRoles.h"
+#include "CsrGraph.h"
+
+using namespace std;
+
+/* Links every actor to each co-star once, labelled with the lightest movie
+ * they share and the movie with the lower id among equally light ones.  An
+ * actor's co-stars come in the order of its movies and, within a movie, of
+ * the cast without the actor itself.  The actors and the first place they
+ * take in each of their casts are sorted out once, so the edges are grouped
+ * by actor from the start.  Then the co-stars of every actor are counted and
+ * written straight into arrays of the exact size, so nothing is allocated
+ * per actor.  Both passes split the actors into ranges of about the same
+ * number of cast slots and run them on pool, every actor is done by one
+ * thread and the result does not depend on the number of threads.
+ */
+void CsrGraph::build(const vector<Movie>& movies, uint32_t num_actors, Arena& arena,
+                     ThreadPool& pool) {
+    CastRoles roles(movies, num_actors);
+
+    // ranges of actors with about the same work, a few per thread
+    size_t num_ranges = pool.size() == 1 ? 1 : pool.size() * 16;
+    vector<uint32_t> range_begin = roles.split(num_ranges);
+
+    // scratch of every thread for countCoStars() and linkCoStars()
+    vector<vector<uint32_t>> owners(pool.size());
+    vector<vector<uint64_t>> slots(pool.size());
+    uint64_t* offset_data = arena.allocate<uint64_t>(num_actors + 1);
+    offset_data[0] = 0;
+
+    pool.parallelFor(num_ranges, [&](size_t r, unsigned worker) {
+        if(owners[worker].empty()) owners[worker].assign(num_actors, NO_ID);
+        uint32_t* owner = owners[worker].data();
+
+        for(uint32_t a = range_begin[r]; a < range_begin[r + 1]; a++) {
+            offset_data[a + 1] = roles.countCoStars(a, owner);
+        }
+    });
+    for(uint32_t a = 0; a < num_actors; a++) {
+        offset_data[a + 1] += offset_data[a];
+    }
+
+    uint64_t num_edges = offset_data[num_actors];
+    uint32_t* target_data = arena.allocate<uint32_t>(num_edges);
+    int* weight_data = arena.allocate<int>(num_edges);
+    uint32_t* movie_data = arena.allocate<uint32_t>(num_edges);
+    for(auto& owner: owners) {
+        fill(owner.begin(), owner.end(), NO_ID);
+    }
+
+    pool.parallelFor(num_ranges, [&](size_t r, unsigned worker) {
+        if(owners[worker].empty()) owners[worker].assign(num_actors, NO_ID);
+        if(slots[worker].empty()) slots[worker].resize(num_actors);
+        uint32_t* owner = owners[worker].data();
+        uint64_t* slot = slots[worker].data();
+
+        for(uint32_t a = range_begin[r]; a < range_begin[r + 1]; a++) {
+            roles.linkCoStars(a, offset_data[a], owner, slot, target_data, weight_data, movie_data);
+        }
+    });
+
+    offsets.view(offset_data, num_actors + 1);
+    targets.view(target_data, num_edges);
+    weights.view(weight_data, num_edges);
+    this->movies.view(movie_data, num_edges);
+}
+
+/* Renumbers the actors: order lists the old ids in their new order and
+ * new_id maps an old id to its new one.  The edges of an actor keep their
+ * order and the arrays are copied into the arena.
+ */
+void CsrGraph::permute(const vector<uint32_t>& order, const vector<uint32_t>& new_id, Arena& arena) {
+    uint32_t num_nodes = numNodes();
+    uint64_t num_edges = numEdges();
+    uint64_t* offset_data = arena.allocate<uint64_t>(num_nodes + 1);
+    uint32_t* target_data = arena.allocate<uint32_t>(num_edges);
+    int* weight_data = arena.allocate<int>(num_edges);
+    uint32_t* movie_data = arena.allocate<uint32_t>(num_edges);
+
+    offset_data[0] = 0;
+    for(uint32_t a = 0; a < num_nodes; a++) {
+        uint64_t slot = offset_data[a];
+        for(uint64_t i = begin(order[a]); i < end(order[a]); i++) {
+            target_data[slot] = new_id[targets[i]];
+            weight_data[slot] = weights[i];
+            movie_data[slot++] = movies[i];
+        }
+        offset_data[a + 1] = slot;
+    }
+
+    offsets.view(offset_data, num_nodes + 1);
+    targets.view(target_data, num_edges);
+    weights.view(weight_data, num_edges);
+    movies.view(movie_data, num_edges);
+}
+
+// Returns the slot of the edge from -> to, or numEdges() if there is none.
+uint64_t CsrGraph::findEdge(uint32_t from, uint32_t to) const {
+    for(uint64_t i = begin(from); i < end(from); i++) {
+        if(targets[i] == to) return i;
+    }
+    return numEdges();
+}
+
+// Adds the adjacency arrays to a snapshot.
+void CsrGraph::save(SnapshotWriter& out) const {
+    out.add(SNAP_CSR_OFFSETS, offsets);
+    out.add(SNAP_CSR_TARGETS, targets);
+    out.add(SNAP_CSR_WEIGHTS, weights);
+    out.add(SNAP_CSR_MOVIES, movies);
+}
+
+/* Uses the adjacency arrays stored in a snapshot in place.  Returns false if
+ * they are missing or do not fit together.
+ */
+bool CsrGraph::load(const SnapshotReader& in) {
+    if(!in.get(SNAP_CSR_OFFSETS, offsets) || !in.get(SNAP_CSR_TARGETS, targets) ||
+       !in.get(SNAP_CSR_WEIGHTS, weights) || !in.get(SNAP_CSR_MOVIES, movies)) {
+        return false;
+    }
+    return !offsets.empty() && offsets.back() == targets.size() &&
+           weights.size() == targets.size() && movies.size() == targets.size();
+}
@@ -0,0 +1,66 @@
+/* 
+ * File: CsrGraph.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the compressed sparse row adjacency of the actor graph.
+ *      The edges of actor u are the slots [offsets[u], offsets[u+1]) of the
+ *      parallel targets, weights and movies arrays, so the search loops walk
+ *      flat memory instead of chasing per-node vectors.  Built in memory the
+ *      arrays live in an Arena owned by the graph.
+ */
+
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "ActorNode.h"
+#include "Arena.h"
+#include "FlatArray.h"
+#include "Movie.h"
+#include "SearchWorkspace.h"
+#include "SnapshotFile.h"
+#include "ThreadPool.h"
+using namespace std;
+
+class CsrGraph
+{
+    public:
+        FlatArray<uint64_t> offsets; // numNodes() + 1 entries
+        FlatArray<uint32_t> targets; // neighbor actor id of every edge
+        FlatArray<int> weights;      // weight of every edge
+        FlatArray<uint32_t> movies;  // movie labelling every edge
+
+        void build(const vector<Movie>& movies, uint32_t num_actors, Arena& arena,
+                   ThreadPool& pool);
+
+        void permute(const vector<uint32_t>& order, const vector<uint32_t>& new_id, Arena& arena);
+
+        void save(SnapshotWriter& out) const;
+
+        bool load(const SnapshotReader& in);
+
+        uint32_t numNodes() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+        uint64_t numEdges() const { return targets.size(); }
+
+        uint64_t begin(uint32_t node) const { return offsets[node]; }
+
+        uint64_t end(uint32_t node) const { return offsets[node + 1]; }
+
+        uint32_t degree(uint32_t node) const { return offsets[node + 1] - offsets[node]; }
+
+        uint64_t findEdge(uint32_t from, uint32_t to) const;
+
+        // Calls f(neighbor, weight, movie) for every edge of node not heavier
+        // than max_weight.  The clique has no per-search state, ws is only
+        // taken to match BipartiteGraph::forEachEdge.
+        template<class F>
+        void forEachEdge(uint32_t node, SearchWorkspace&, F f, int max_weight = INT_MAX) const {
+            for(uint64_t i = offsets[node]; i < offsets[node + 1]; i++) {
+                if(weights[i] <= max_weight) {
+                    f(targets[i], weights[i], movies[i]);
+                }
+            }
+        }
+};
+#endif
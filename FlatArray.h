@@ -0,0 +1,122 @@
+/* 
+ * File: FlatArray.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the flat array used for every large array of the graph.
+ *      It either owns its elements in a vector or is a read-only view of
+ *      memory owned by someone else, in practice a mapped graph snapshot, so
+ *      a graph can be used straight out of the page cache without copying.
+ */
+
+#ifndef FLATARRAY_H
+#define FLATARRAY_H
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+template<class T>
+class FlatArray
+{
+    private:
+        vector<T> owned;
+        T* ptr;       // owned.data() or the viewed memory
+        size_t count;
+        bool is_view;
+
+        void sync() { ptr = owned.data(); count = owned.size(); }
+
+    public:
+        FlatArray(void) : ptr(nullptr), count(0), is_view(false) {}
+
+        FlatArray(size_t n, const T& value) : owned(n, value), is_view(false) { sync(); }
+
+        FlatArray(const FlatArray& other) : owned(other.owned), ptr(other.ptr),
+                                            count(other.count), is_view(other.is_view) {
+            if(!is_view) sync();
+        }
+
+        FlatArray(FlatArray&& other) : owned(move(other.owned)), ptr(other.ptr),
+                                       count(other.count), is_view(other.is_view) {
+            if(!is_view) sync();
+            other.is_view = false;
+            other.sync();
+        }
+
+        FlatArray& operator=(FlatArray other) {
+            owned.swap(other.owned);
+            is_view = other.is_view;
+            ptr = other.ptr;
+            count = other.count;
+            if(!is_view) sync();
+            return *this;
+        }
+
+        /* Makes this array a view of n elements at data.  The memory must
+         * outlive the array and is never written through it.
+         */
+        void view(const T* data, size_t n) {
+            vector<T>().swap(owned);
+            ptr = const_cast<T*>(data);
+            count = n;
+            is_view = true;
+        }
+
+        bool isView() const { return is_view; }
+
+        // vector-like interface.  Modifiers are copy-on-write: resize, reserve,
+        // push_back and append first copy a view into owned memory with own(),
+        // assign and clear replace its contents and drop the view
+        void assign(size_t n, const T& value) { is_view = false; owned.assign(n, value); sync(); }
+
+        template<class It>
+        void assign(It first, It last) { is_view = false; owned.assign(first, last); sync(); }
+
+        void resize(size_t n) { own(); owned.resize(n); sync(); }
+
+        void resize(size_t n, const T& value) { own(); owned.resize(n, value); sync(); }
+
+        void reserve(size_t n) { own(); owned.reserve(n); sync(); }
+
+        void push_back(const T& value) { own(); owned.push_back(value); sync(); }
+
+        template<class It>
+        void append(It first, It last) { own(); owned.insert(owned.end(), first, last); sync(); }
+
+        void clear() { is_view = false; vector<T>().swap(owned); sync(); }
+
+        // copies a view into owned memory so it can be modified
+        void own() {
+            if(is_view) {
+                vector<T> copy(ptr, ptr + count);
+                owned.swap(copy);
+                is_view = false;
+                sync();
+            }
+        }
+
+        size_t size() const { return count; }
+
+        bool empty() const { return count == 0; }
+
+        size_t capacity() const { return is_view ? 0 : owned.capacity(); }
+
+        T* data() { return ptr; }
+
+        const T* data() const { return ptr; }
+
+        T& operator[](size_t i) { return ptr[i]; }
+
+        const T& operator[](size_t i) const { return ptr[i]; }
+
+        T& back() { return ptr[count - 1]; }
+
+        const T& back() const { return ptr[count - 1]; }
+
+        T* begin() { return ptr; }
+
+        T* end() { return ptr + count; }
+
+        const T* begin() const { return ptr; }
+
+        const T* end() const { return ptr + count; }
+};
+#endif
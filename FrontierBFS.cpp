@@ -0,0 +1,169 @@
+/*
+ * File: FrontierBFS.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements the direction-optimizing breadth first search.  The
+ *      frontier bitmaps are cut into tasks of WORDS_PER_TASK words.  A
+ *      top-down step claims an actor by swapping its parent from NO_ID, so
+ *      exactly one thread adds it to the next frontier.  A bottom-up step
+ *      only writes the actors of its own words and needs no claims.
+ */
+
+#include <algorithm>
+#include "FrontierBFS.h"
+
+using namespace std;
+
+static const size_t WORDS_PER_TASK = 64;
+
+// Go bottom-up once the frontier has more than 1/ALPHA of the unexplored
+// edges, and back top-down once it has less than 1/BETA of the actors.
+// These are the values Beamer et al. found to work on most graphs.
+static const uint64_t ALPHA = 14;
+static const uint64_t BETA = 24;
+
+FrontierBFS::FrontierBFS(void) : top_down_steps(0), bottom_up_steps(0) {}
+
+/* Pushes every actor of the frontier to its neighbors that have no parent
+ * yet.
+ */
+void FrontierBFS::topDownStep(const CsrGraph& graph, ThreadPool& pool, int level) {
+    size_t num_words = frontier.size();
+    size_t num_tasks = (num_words + WORDS_PER_TASK - 1) / WORDS_PER_TASK;
+
+    pool.parallelFor(num_tasks, [&](size_t task, unsigned worker) {
+        size_t last = min(num_words, (task + 1) * WORDS_PER_TASK);
+        uint64_t nodes = 0;
+        uint64_t edges = 0;
+
+        for(size_t w = task * WORDS_PER_TASK; w < last; w++) {
+            uint64_t bits = frontier[w].load(memory_order_relaxed);
+            while(bits != 0) {
+                uint32_t u = w * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+
+                for(uint64_t i = graph.begin(u); i < graph.end(u); i++) {
+                    uint32_t v = graph.targets[i];
+                    if(parents[v].load(memory_order_relaxed) != NO_ID) continue;
+
+                    uint32_t expected = NO_ID;
+                    if(parents[v].compare_exchange_strong(expected, u, memory_order_relaxed)) {
+                        dist[v] = level + 1;
+                        next[v / 64].fetch_or(1ULL << (v % 64), memory_order_relaxed);
+                        nodes++;
+                        edges += graph.degree(v);
+                    }
+                }
+            }
+        }
+        added_nodes[worker] += nodes;
+        added_edges[worker] += edges;
+    });
+}
+
+/* Lets every actor without a parent take the first of its neighbors that is
+ * in the frontier.
+ */
+void FrontierBFS::bottomUpStep(const CsrGraph& graph, ThreadPool& pool, int level) {
+    uint32_t num_nodes = graph.numNodes();
+    size_t num_words = frontier.size();
+    size_t num_tasks = (num_words + WORDS_PER_TASK - 1) / WORDS_PER_TASK;
+
+    pool.parallelFor(num_tasks, [&](size_t task, unsigned worker) {
+        size_t last = min(num_words, (task + 1) * WORDS_PER_TASK);
+        uint64_t nodes = 0;
+        uint64_t edges = 0;
+
+        for(size_t w = task * WORDS_PER_TASK; w < last; w++) {
+            uint64_t found = 0;
+            uint32_t end = min<uint64_t>(num_nodes, (w + 1) * 64);
+
+            for(uint32_t v = w * 64; v < end; v++) {
+                if(parents[v].load(memory_order_relaxed) != NO_ID) continue;
+
+                for(uint64_t i = graph.begin(v); i < graph.end(v); i++) {
+                    uint32_t u = graph.targets[i];
+                    if((frontier[u / 64].load(memory_order_relaxed) >> (u % 64) & 1) == 0) continue;
+
+                    parents[v].store(u, memory_order_relaxed);
+                    dist[v] = level + 1;
+                    found |= 1ULL << (v % 64);
+                    nodes++;
+                    edges += graph.degree(v);
+                    break;
+                }
+            }
+            next[w].store(found, memory_order_relaxed);
+        }
+        added_nodes[worker] += nodes;
+        added_edges[worker] += edges;
+    });
+}
+
+/* Searches the whole component of source.  Afterwards dist holds the number
+ * of edges from source to every actor and parent() the actor before it on
+ * one shortest path, source for source itself and NO_ID for actors that
+ * were not reached.  Returns the number of actors reached.
+ */
+uint32_t FrontierBFS::search(const CsrGraph& graph, ThreadPool& pool, uint32_t source) {
+    uint32_t num_nodes = graph.numNodes();
+    size_t num_words = (num_nodes + 63) / 64;
+    if(parents.size() != num_nodes) {
+        parents = vector<atomic<uint32_t>>(num_nodes);
+        frontier = vector<atomic<uint64_t>>(num_words);
+        next = vector<atomic<uint64_t>>(num_words);
+    }
+    for(auto& p: parents) {
+        p.store(NO_ID, memory_order_relaxed);
+    }
+    for(auto& w: frontier) {
+        w.store(0, memory_order_relaxed);
+    }
+    dist.assign(num_nodes, INT_MAX);
+    top_down_steps = 0;
+    bottom_up_steps = 0;
+
+    parents[source].store(source, memory_order_relaxed);
+    dist[source] = 0;
+    frontier[source / 64].store(1ULL << (source % 64), memory_order_relaxed);
+
+    uint64_t frontier_nodes = 1;
+    uint64_t frontier_edges = graph.degree(source);
+    uint64_t unexplored_edges = graph.numEdges() - frontier_edges;
+    uint32_t reached = 1;
+    bool bottom_up = false;
+
+    for(int level = 0; frontier_nodes > 0; level++) {
+        if(!bottom_up && frontier_edges > unexplored_edges / ALPHA) {
+            bottom_up = true;
+        }
+        else if(bottom_up && frontier_nodes < num_nodes / BETA) {
+            bottom_up = false;
+        }
+
+        for(auto& w: next) {
+            w.store(0, memory_order_relaxed);
+        }
+        added_nodes.assign(pool.size(), 0);
+        added_edges.assign(pool.size(), 0);
+
+        if(bottom_up) {
+            bottomUpStep(graph, pool, level);
+            bottom_up_steps++;
+        }
+        else {
+            topDownStep(graph, pool, level);
+            top_down_steps++;
+        }
+
+        frontier_nodes = 0;
+        frontier_edges = 0;
+        for(unsigned t = 0; t < pool.size(); t++) {
+            frontier_nodes += added_nodes[t];
+            frontier_edges += added_edges[t];
+        }
+        unexplored_edges -= frontier_edges;
+        reached += frontier_nodes;
+        frontier.swap(next);
+    }
+    return reached;
+}
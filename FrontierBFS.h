@@ -0,0 +1,51 @@
+/*
+ * File: FrontierBFS.h
+ * Date: December 4, 2017
+ * Purpose: Declares a parallel breadth first search over the clique
+ *      adjacency for searches that reach most of a large graph.  Each level
+ *      is one parallel step over bitmaps of the current and the next
+ *      frontier.  A step either pushes from the frontier to its unvisited
+ *      neighbors (top-down) or lets every unvisited actor look for a
+ *      neighbor in the frontier (bottom-up), whichever has fewer edges to
+ *      check, as in Beamer, Asanovic and Patterson's direction-optimizing
+ *      BFS.
+ */
+
+#ifndef FRONTIERBFS_H
+#define FRONTIERBFS_H
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "ActorNode.h"
+#include "CsrGraph.h"
+#include "ThreadPool.h"
+using namespace std;
+
+class FrontierBFS
+{
+    private:
+        vector<atomic<uint32_t>> parents;
+        vector<atomic<uint64_t>> frontier; // one bit per actor
+        vector<atomic<uint64_t>> next;
+
+        // counts of the actors and their edges added to next, per worker
+        vector<uint64_t> added_nodes;
+        vector<uint64_t> added_edges;
+
+        void topDownStep(const CsrGraph& graph, ThreadPool& pool, int level);
+
+        void bottomUpStep(const CsrGraph& graph, ThreadPool& pool, int level);
+
+    public:
+        vector<int> dist; // INT_MAX if not reached
+        unsigned top_down_steps;
+        unsigned bottom_up_steps;
+
+        FrontierBFS(void);
+
+        uint32_t parent(uint32_t actor) const { return parents[actor].load(memory_order_relaxed); }
+
+        uint32_t search(const CsrGraph& graph, ThreadPool& pool, uint32_t source);
+};
+#endif
@@ -0,0 +1,52 @@
+/*
+ * File: Landmarks.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements filling the landmark table and keeping it in a
+ *      snapshot next to the graph it was computed on.
+ */
+
+#include <algorithm>
+#include "Landmarks.h"
+
+using namespace std;
+
+/* Takes the landmarks and their distances, dist_table holds
+ * landmarks.size() entries per actor.
+ */
+void Landmarks::assign(const vector<uint32_t>& landmarks, const vector<int>& dist_table) {
+    actors.assign(landmarks.begin(), landmarks.end());
+    dists.assign(dist_table.begin(), dist_table.end());
+}
+
+/* Follows a renumbering of the actors: order lists the old ids in their new
+ * order and new_id maps an old id to its new one.
+ */
+void Landmarks::permute(const vector<uint32_t>& order, const vector<uint32_t>& new_id) {
+    uint32_t k = numLandmarks();
+    vector<uint32_t> landmarks;
+    for(uint32_t actor: actors) {
+        landmarks.push_back(new_id[actor]);
+    }
+
+    vector<int> dist_table(dists.size());
+    for(uint32_t a = 0; a < order.size(); a++) {
+        copy_n(dists.data() + (uint64_t) order[a] * k, k, dist_table.begin() + (uint64_t) a * k);
+    }
+    assign(landmarks, dist_table);
+}
+
+// Adds the landmark table to a snapshot.
+void Landmarks::save(SnapshotWriter& out) const {
+    out.add(SNAP_LANDMARK_ACTORS, actors);
+    out.add(SNAP_LANDMARK_DISTS, dists);
+}
+
+/* Uses the landmark table stored in a snapshot in place.  Returns false if
+ * it is missing or does not fit together.
+ */
+bool Landmarks::load(const SnapshotReader& in) {
+    if(!in.get(SNAP_LANDMARK_ACTORS, actors) || !in.get(SNAP_LANDMARK_DISTS, dists)) {
+        return false;
+    }
+    return !actors.empty() && dists.size() % actors.size() == 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * File: Landmarks.h
+ * Date: December 4, 2017
+ * Purpose: Declares the landmark table of the A* search (ALT).  For a few
+ *      landmark actors it holds the exact weighted distance to every actor,
+ *      stored actor by actor so the bounds of one actor are next to each
+ *      other.  By the triangle inequality |d(L, a) - d(L, b)| is at most the
+ *      distance between a and b for every landmark L, the largest of these
+ *      is the lower bound A* aims with.  selectLandmarks() in PathSearch.h
+ *      fills the table.
+ */
+
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "FlatArray.h"
+#include "SnapshotFile.h"
+using namespace std;
+
+class Landmarks
+{
+    private:
+        FlatArray<uint32_t> actors; // the landmarks
+        FlatArray<int> dists;       // numLandmarks() per actor, INT_MAX if unreachable
+
+    public:
+        void assign(const vector<uint32_t>& landmarks, const vector<int>& dist_table);
+
+        bool built() const { return !actors.empty(); }
+
+        uint32_t numLandmarks() const { return actors.size(); }
+
+        uint32_t numActors() const { return actors.empty() ? 0 : dists.size() / actors.size(); }
+
+        uint32_t landmark(uint32_t i) const { return actors[i]; }
+
+        /* Returns a lower bound of the distance from actor to end, INT_MAX if
+         * a landmark reaches exactly one of them so there is no path.
+         */
+        int lowerBound(uint32_t actor, uint32_t end) const {
+            uint32_t k = actors.size();
+            const int* from = dists.data() + (uint64_t) actor * k;
+            const int* to = dists.data() + (uint64_t) end * k;
+            int bound = 0;
+            for(uint32_t i = 0; i < k; i++) {
+                if(from[i] == INT_MAX || to[i] == INT_MAX) {
+                    if(from[i] != to[i]) return INT_MAX;
+                    continue;
+                }
+                int diff = from[i] > to[i] ? from[i] - to[i] : to[i] - from[i];
+                if(diff > bound) bound = diff;
+            }
+            return bound;
+        }
+
+        void permute(const vector<uint32_t>& order, const vector<uint32_t>& new_id);
+
+        void save(SnapshotWriter& out) const;
+
+        bool load(const SnapshotReader& in);
+};
+#endif
@@ -0,0 +1,64 @@
+/* 
+ * File: MappedFile.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the read-only memory mapping used by the zero-copy
+ *      loaders.  An empty file is a valid mapping of size 0.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.h"
+
+using namespace std;
+
+// Constructor
+MappedFile::MappedFile(void) : fd(-1), map_data(nullptr), map_size(0) {}
+
+/* Opens and maps the whole file.  Returns false if the file cannot be opened
+ * or mapped, in which case the object stays empty.
+ */
+bool MappedFile::open(const char* filename) {
+    close();
+
+    fd = ::open(filename, O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close();
+        return false;
+    }
+
+    map_size = st.st_size;
+    if(map_size == 0) return true; // nothing to map, but nothing to read either
+
+    void* addr = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(addr == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    // rows are consumed front to back, let the kernel read ahead aggressively
+    madvise(addr, map_size, MADV_SEQUENTIAL);
+    map_data = static_cast<const char*>(addr);
+    return true;
+}
+
+// Unmaps the file and closes the descriptor.
+void MappedFile::close() {
+    if(map_data != nullptr) {
+        munmap(const_cast<char*>(map_data), map_size);
+    }
+    if(fd >= 0) {
+        ::close(fd);
+    }
+    fd = -1;
+    map_data = nullptr;
+    map_size = 0;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
@@ -0,0 +1,41 @@
+/* 
+ * File: MappedFile.h
+ * Date: December 4, 2017  
+ * Purpose: Declares a read-only memory mapping of a whole file so that the
+ *      loaders can parse rows as string_views straight out of the page cache
+ *      instead of copying every line into a std::string.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <cstddef>
+#include <string_view>
+using namespace std;
+
+class MappedFile
+{
+    private:
+        int fd;
+        const char* map_data;
+        size_t map_size;
+
+    public:
+        MappedFile(void);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const char* filename);
+
+        void close();
+
+        const char* data() const { return map_data; }
+
+        size_t size() const { return map_size; }
+
+        string_view view() const { return string_view(map_data, map_size); }
+};
+#endif
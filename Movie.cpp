@@ -13,25 +13,18 @@
 #include "ActorNode.h"
 using namespace std;
 
-// Constructor
-Movie::Movie(string title, int year) : title(title), year(year), weight(1) {}
+// Constructor, name is the string table id of the formatted title#@year
+Movie::Movie(uint32_t name, int year) : weight(1), name(name), year(year) {}
 
-// Add ActorNode pointers to the movie's cast.
-void Movie::addActor(ActorNode* actor) {
-	cast.push_back(actor);
+// Constructor for a movie whose cast is stored elsewhere, e.g. in a snapshot
+Movie::Movie(uint32_t name, int year, int weight, const uint32_t* cast, uint32_t cast_size)
+    : weight(weight), name(name), year(year) {
+	this->cast.view(cast, cast_size);
 }
 
-/* Create edges between each pair of actors in the cast.
- * The first argument is the other end of the edge (other actor)while the second
- * and third are the formatted movie title (printed edge) and movie weight.
- */
-void Movie::makeEdges() {
-	for(unsigned int i = 0; i < cast.size() - 1; i++) {
-		for(unsigned int j = i + 1; j < cast.size(); j++) {
-			cast[i]->addNeighbor(cast[j], title + "#@" + to_string(year), weight);
-			cast[j]->addNeighbor(cast[i], title + "#@" + to_string(year), weight);
-		}
-	}
+// Use the cast_size actor ids at cast, stored by the graph, as the movie's cast.
+void Movie::setCast(const uint32_t* cast, uint32_t cast_size) {
+	this->cast.view(cast, cast_size);
 }
 
 // Caluclate the weight of the movie.
@@ -39,49 +32,19 @@ void Movie::calcWeight() {
 	weight = 1 + (2015 - year);
 }
 
+// Use the year of the movie as its weight.
+void Movie::useYear() {
+	weight = year;
+}
+
 // Overloaded operator used to sort Movie's by year in priority queue.
 bool Movie::operator<(const Movie& other) {
 	return this->year > other.year;
 }
 
-// Find sentinel node of a specified node.
-ActorNode* Movie::find(ActorNode* node){
-    ActorNode* curr;
-    curr = node;
-    
-    while(curr->parent != nullptr) { //traverse up
-        curr = curr->parent;
-    }
-    return curr;
-}
-
-/* Merge two disjoint sets by making the sentinel node of one set the parent of 
- * the other based on size.
- */
-void Movie::merge(ActorNode* n1, ActorNode* n2) {
-    ActorNode* sent1;
-    ActorNode* sent2;
-
-    sent1 = find(n1);
-    sent2 = find(n2);
-
-    if(sent1 == sent2) return;  // have been merged
-
-    if(sent1->size > sent2->size) { //merge to the larger tree
-        sent2->parent = sent1;
-        sent1->size += sent2->size;
-    }
-    else {
-        sent1->parent = sent2;
-        sent2->size += sent1->size;
-    }
-}
-
-// Perform union find on all ActorNodes in Movie's cast.
-void Movie::ufind(){
-    for(unsigned int i = 0; i < cast.size() - 1; i++) {
-        for(unsigned int j = i + 1; j < cast.size(); j++) {
-            merge(cast[i], cast[j]);
-        }
+// Puts all actors in Movie's cast into one set, k - 1 merges for k actors.
+void Movie::ufind(UnionFind& sets) const {
+    for(unsigned int i = 1; i < cast.size(); i++) {
+        sets.merge(cast[0], cast[i]);
     }
 }
@@ -8,27 +8,32 @@
  *      Implements functions for ufind algorithm needed as well*/
 #ifndef MOVIE_H
 #define MOVIE_H
+#include <cstdint>
 #include <vector>
 #include <string>
 #include "ActorNode.h"
+#include "FlatArray.h"
+#include "UnionFind.h"
 using namespace std;
 
 class Movie
 {
 	private:
-		vector<ActorNode*> cast;
-		string title;
+		FlatArray<uint32_t> cast; // actor ids in the order they were read
 		int weight;
 
 	public:
+        uint32_t name; // id of title#@year in the graph's string table
         int year;
-		Movie(string title, int year);
-		void addActor(ActorNode* actor);
-		void makeEdges();
+		Movie(uint32_t name, int year);
+		Movie(uint32_t name, int year, int weight, const uint32_t* cast, uint32_t cast_size);
+		void setCast(const uint32_t* cast, uint32_t cast_size);
 		void calcWeight();
-        void merge(ActorNode* n1, ActorNode* n2);
-        ActorNode* find(ActorNode* node);
-        void ufind();
+		void useYear();
+        void ufind(UnionFind& sets) const;
+
+		const FlatArray<uint32_t>& getCast() const { return cast; }
+		int getWeight() const { return weight; }
 
 		bool operator<(const Movie& other);
 };
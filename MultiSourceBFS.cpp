@@ -0,0 +1,72 @@
+/*
+ * File: MultiSourceBFS.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements setting up and clearing the multi-source search.  Only
+ *      the actors a search touched are cleared, so a batch of sources costs
+ *      the part of the graph it explored and not the whole graph.
+ */
+
+#include <algorithm>
+#include "MultiSourceBFS.h"
+
+using namespace std;
+
+MultiSourceBFS::MultiSourceBFS(void) : num_sources(0), active(0), complete(true) {}
+
+// Sizes the per actor state for num_actors actors, all unreached.
+void MultiSourceBFS::resize(uint32_t num_actors) {
+    seen.assign(num_actors, 0);
+    visit.assign(num_actors, 0);
+    next_visit.assign(num_actors, 0);
+    wanted.assign(num_actors, 0);
+    dists.assign((uint64_t) num_actors * MAX_SOURCES, UNREACHED);
+    frontier.clear();
+    touched.clear();
+    num_sources = 0;
+    active = 0;
+}
+
+// Forgets the sources, pairs and distances of the last search.
+void MultiSourceBFS::clear() {
+    for(uint32_t actor: touched) {
+        seen[actor] = 0;
+        visit[actor] = 0;
+        wanted[actor] = 0;
+        fill_n(dists.begin() + (uint64_t) actor * MAX_SOURCES, MAX_SOURCES, UNREACHED);
+    }
+    touched.clear();
+    frontier.clear();
+    num_sources = 0;
+    active = 0;
+}
+
+/* Starts a search from actor and returns its index, at most MAX_SOURCES
+ * sources can be added between two clear() calls.
+ */
+uint32_t MultiSourceBFS::addSource(uint32_t actor) {
+    uint32_t source = num_sources++;
+    uint64_t bit = 1ULL << source;
+
+    touch(actor);
+    if(visit[actor] == 0) frontier.push_back(actor);
+    seen[actor] |= bit;
+    visit[actor] |= bit;
+    dists[(uint64_t) actor * MAX_SOURCES + source] = 0;
+    remaining[source] = 0;
+    return source;
+}
+
+/* Asks the search to go on until the source with index source reached end.
+ * Sources have to be added before the pairs that use them.
+ */
+void MultiSourceBFS::want(uint32_t source, uint32_t end) {
+    uint64_t bit = 1ULL << source;
+    if((wanted[end] & bit) != 0) return;
+
+    touch(end);
+    wanted[end] |= bit;
+    if((seen[end] & bit) == 0) {
+        remaining[source]++;
+        active |= bit;
+    }
+}
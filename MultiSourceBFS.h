@@ -0,0 +1,159 @@
+/*
+ * File: MultiSourceBFS.h
+ * Date: December 4, 2017
+ * Purpose: Declares a breadth first search from up to 64 sources at once,
+ *      the MS-BFS of Then et al.  Every actor keeps one bit per source in
+ *      the seen, visit and next_visit words, so a single pass over the edges
+ *      of a level advances all the searches that reached it.  The search
+ *      stops once every wanted (source, end) pair was reached and records
+ *      the distance of every actor from every source in a byte, from which
+ *      tracePath() rebuilds the same path as bidirectionalBFS.
+ */
+
+#ifndef MULTISOURCEBFS_H
+#define MULTISOURCEBFS_H
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "ActorNode.h"
+#include "SearchWorkspace.h"
+using namespace std;
+
+class MultiSourceBFS
+{
+    private:
+        vector<uint64_t> seen;       // bit i: source i has reached the actor
+        vector<uint64_t> visit;      // bit i: the actor is in the frontier of source i
+        vector<uint64_t> next_visit;
+        vector<uint64_t> wanted;     // bit i: the actor is the end of a pair of source i
+        vector<uint8_t> dists;       // MAX_SOURCES per actor, UNREACHED if not seen
+        vector<uint32_t> frontier;
+        vector<uint32_t> next_frontier;
+        vector<uint32_t> touched;    // actors with state to clear
+        uint32_t num_sources;
+        uint32_t remaining[64];      // wanted ends of each source not reached yet
+        uint64_t active;             // bit i: source i still has ends to reach
+        bool complete;
+
+        void touch(uint32_t actor) {
+            if(seen[actor] == 0 && wanted[actor] == 0) touched.push_back(actor);
+        }
+
+    public:
+        static constexpr uint32_t MAX_SOURCES = 64;
+        static constexpr int MAX_DEPTH = 254;
+        static constexpr uint8_t UNREACHED = 255;
+
+        MultiSourceBFS(void);
+
+        void resize(uint32_t num_actors);
+
+        void clear();
+
+        uint32_t addSource(uint32_t actor);
+
+        void want(uint32_t source, uint32_t end);
+
+        uint32_t numSources() const { return num_sources; }
+
+        /* Returns the distance of actor from the source with index source,
+         * INT_MAX if the search did not reach it.  If complete() is false the
+         * search gave up at MAX_DEPTH and an unreached actor may still be
+         * further away.
+         */
+        int dist(uint32_t source, uint32_t actor) const {
+            uint8_t d = dists[(uint64_t) actor * MAX_SOURCES + source];
+            return d == UNREACHED ? INT_MAX : d;
+        }
+
+        bool isComplete() const { return complete; }
+
+        template<class Graph>
+        void search(const Graph& graph, SearchWorkspace& ws);
+
+        template<class Graph>
+        void tracePath(const Graph& graph, SearchWorkspace& ws, SearchWorkspace& scratch,
+                       uint32_t source, uint32_t start, uint32_t end) const;
+};
+
+/* Runs the searches of all sources added since clear() level by level until
+ * every wanted pair was reached or no source has a frontier left.  ws is
+ * reset before expanding each actor, so the bipartite adjacency hands over
+ * every movie each time.
+ */
+template<class Graph>
+void MultiSourceBFS::search(const Graph& graph, SearchWorkspace& ws) {
+    complete = true;
+    for(int depth = 0; !frontier.empty() && active != 0; depth++) {
+        if(depth == MAX_DEPTH) { // deeper distances do not fit in a byte
+            complete = false;
+            break;
+        }
+
+        next_frontier.clear();
+        for(uint32_t curr: frontier) {
+            uint64_t bits = visit[curr] & active; // finished sources stop here
+            visit[curr] = 0;
+            if(bits == 0) continue;
+
+            ws.reset();
+            graph.forEachEdge(curr, ws, [&](uint32_t next, int, uint32_t) {
+                uint64_t fresh = bits & ~seen[next];
+                if(fresh == 0) return;
+
+                if(next_visit[next] == 0) next_frontier.push_back(next);
+                next_visit[next] |= fresh;
+            });
+        }
+
+        // the sources that reached an actor first in this level
+        for(uint32_t next: next_frontier) {
+            uint64_t fresh = next_visit[next];
+            next_visit[next] = 0;
+
+            touch(next);
+            seen[next] |= fresh;
+            visit[next] = fresh;
+            for(uint64_t bits = fresh & wanted[next]; bits != 0; bits &= bits - 1) {
+                uint32_t source = __builtin_ctzll(bits);
+                if(--remaining[source] == 0) active &= ~(1ULL << source);
+            }
+            for(uint64_t bits = fresh; bits != 0; bits &= bits - 1) {
+                dists[(uint64_t) next * MAX_SOURCES + __builtin_ctzll(bits)] = depth + 1;
+            }
+        }
+        frontier.swap(next_frontier);
+    }
+}
+
+/* Leaves in ws the path from start, the actor of index source, to end the
+ * way findShortestPath() does: dist of end is the length and the prev of
+ * every actor on the path its lowest rank neighbor one step closer to start.
+ * end must have been reached.
+ */
+template<class Graph>
+void MultiSourceBFS::tracePath(const Graph& graph, SearchWorkspace& ws, SearchWorkspace& scratch,
+                               uint32_t source, uint32_t start, uint32_t end) const {
+    ws.reset();
+    ws.setDist(end, dist(source, end));
+
+    for(uint32_t curr = end; curr != start; curr = ws.prev(curr)) {
+        int depth = dist(source, curr);
+        uint32_t prev = NO_ID;
+        uint32_t prev_rank = NO_ID;
+        uint32_t prev_movie = NO_ID;
+
+        scratch.reset(); // look at every movie of curr
+        graph.forEachEdge(curr, scratch, [&](uint32_t next, int, uint32_t movie) {
+            uint32_t rank = ws.rank(next);
+            if(rank < prev_rank && dist(source, next) == depth - 1) {
+                prev = next;
+                prev_rank = rank;
+                prev_movie = movie;
+            }
+        });
+
+        ws.setPrev(curr, prev, prev_movie);
+    }
+}
+#endif
@@ -0,0 +1,115 @@
+/*
+ * File: NodeOrder.h
+ * Date: December 4, 2017
+ * Purpose: Defines the orders ActorGraph::reorder() can renumber the actors
+ *      in.  Actors are numbered in order of first appearance in the cast
+ *      file, so the co-stars of an actor are spread over the whole id range
+ *      and every search touches the per-actor arrays all over.  Numbering
+ *      actors that are searched together next to each other keeps more of
+ *      a search in the cache:
+ *      bfs     breadth first from the actor with the most co-stars, so every
+ *              level of a search is a few runs of ids
+ *      degree  most co-stars first, the actors most searches go through
+ *              share the first cache lines
+ *      rcm     reverse Cuthill-McKee, breadth first from an actor with few
+ *              co-stars taking the neighbors in increasing degree, then
+ *              reversed.  Keeps the ids of the two ends of an edge close
+ */
+
+#ifndef NODEORDER_H
+#define NODEORDER_H
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string_view>
+#include <vector>
+#include "SearchWorkspace.h"
+using namespace std;
+
+enum NodeOrdering
+{
+    NATURAL_ORDER = 0, // order of first appearance, what the loaders give
+    BFS_ORDER = 1,
+    DEGREE_ORDER = 2,
+    RCM_ORDER = 3
+};
+
+/**Function to read the name of an ordering
+ * Purpose: Sets how from natural, bfs, degree or rcm, returns false for
+ *      any other name **/
+inline bool parseNodeOrdering(string_view name, NodeOrdering& how) {
+    if(name == "natural") how = NATURAL_ORDER;
+    else if(name == "bfs") how = BFS_ORDER;
+    else if(name == "degree") how = DEGREE_ORDER;
+    else if(name == "rcm") how = RCM_ORDER;
+    else return false;
+    return true;
+}
+
+/**Function to count the co-stars of every actor
+ * Purpose: Returns how many edges forEachEdge() gives for every actor, for
+ *      the incidence lists a co-star in several movies counts once per movie **/
+template<class Graph>
+vector<uint32_t> nodeDegrees(const Graph& graph, SearchWorkspace& ws) {
+    vector<uint32_t> degrees(graph.numNodes(), 0);
+    for(uint32_t a = 0; a < graph.numNodes(); a++) {
+        ws.reset(); // every movie of a, not just the unexpanded ones
+        graph.forEachEdge(a, ws, [&](uint32_t, int, uint32_t) { degrees[a]++; });
+    }
+    return degrees;
+}
+
+/**Function to compute a new numbering of the actors
+ * Purpose: Returns the actors in the order how puts them, the actor at
+ *      position i gets id i.  Equal degrees keep the current order and the
+ *      co-stars found together keep the order of the adjacency.  Every
+ *      actor appears once whether it has co-stars or not
+ * Inputs: The adjacency to order, a workspace sized for it and the order **/
+template<class Graph>
+vector<uint32_t> orderNodes(const Graph& graph, SearchWorkspace& ws, NodeOrdering how) {
+    uint32_t num_nodes = graph.numNodes();
+    vector<uint32_t> order(num_nodes);
+    iota(order.begin(), order.end(), 0);
+    if(how == NATURAL_ORDER) return order;
+
+    vector<uint32_t> degrees = nodeDegrees(graph, ws);
+    if(how == DEGREE_ORDER) {
+        stable_sort(order.begin(), order.end(),
+                    [&](uint32_t a, uint32_t b) { return degrees[a] > degrees[b]; });
+        return order;
+    }
+
+    // bfs starts every component from its highest degree actor, rcm from
+    // its lowest
+    vector<uint32_t> seeds(order);
+    stable_sort(seeds.begin(), seeds.end(), [&](uint32_t a, uint32_t b) {
+        return how == BFS_ORDER ? degrees[a] > degrees[b] : degrees[a] < degrees[b];
+    });
+
+    ws.reset(); // done marks the actors already placed, one search for all
+    order.clear();
+    for(uint32_t seed: seeds) {
+        if(ws.done(seed)) continue;
+        ws.setDone(seed);
+        order.push_back(seed);
+
+        for(size_t head = order.size() - 1; head < order.size(); head++) {
+            size_t level_begin = order.size();
+            graph.forEachEdge(order[head], ws, [&](uint32_t next, int, uint32_t) {
+                if(ws.done(next)) return;
+                ws.setDone(next);
+                order.push_back(next);
+            });
+            if(how == RCM_ORDER) { // Cuthill-McKee takes the neighbors lightest first
+                stable_sort(order.begin() + level_begin, order.end(),
+                            [&](uint32_t a, uint32_t b) { return degrees[a] < degrees[b]; });
+            }
+        }
+    }
+
+    if(how == RCM_ORDER) {
+        reverse(order.begin(), order.end());
+    }
+    return order;
+}
+#endif
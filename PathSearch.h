@@ -0,0 +1,413 @@
+/* 
+ * File: PathSearch.h
+ * Date: December 4, 2017  
+ * Purpose: Implements the shortest path searches pathfinder and graphbench
+ *      run on either adjacency of the graph.  They only read the graph and
+ *      keep their state in the SearchWorkspace and queue of the calling
+ *      thread.
+ */
+
+#ifndef PATHSEARCH_H
+#define PATHSEARCH_H
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Landmarks.h"
+#include "PathTreeCache.h"
+#include "SearchQueue.h"
+#include "SearchWorkspace.h"
+using namespace std;
+
+// how a search orders the actors it settles
+enum SearchEngine
+{
+    BIDIRECTIONAL_BFS, // unit weights only
+    HEAP_DIJKSTRA,
+    BUCKET_DIJKSTRA,   // weights from 1 to the max the queue was set up for
+    ALT_ASTAR          // weights of at least 1 and a landmark table
+};
+
+/** what one thread needs to answer pairs on its own **/
+struct PathWorker
+{
+    SearchWorkspace ws;
+    SearchWorkspace back_ws; // backward half of the bidirectional BFS
+    HeapQueue heap;
+    BucketQueue buckets;
+    const Landmarks* landmarks; // bounds of ALT_ASTAR
+
+    PathWorker(void) : landmarks(nullptr) {}
+};
+
+/**Function to implement dijkstra's algorithm
+ * Purpose: Sets dist, prev and prev_movie in ws of the actors reachable from
+ *      start and stops as soon as end is settled.  Ties are settled in order
+ *      of actor rank and only strictly shorter paths replace a prev, so the
+ *      clique and bipartite adjacencies give the same paths
+ * Inputs: The adjacency to search, the workspace of this thread, the queue
+ *      engine (HeapQueue, or BucketQueue if every weight is at least 1) and
+ *      the ids of two actors **/
+template<class Graph, class Queue>
+void dijkstra(const Graph& graph, SearchWorkspace& ws, Queue& pq, uint32_t start, uint32_t end) {
+    // (distance, rank) pairs, ties are popped in order of actor rank
+    pq.clear();
+
+    ws.setDist(start, 0);
+    pq.push(0, ws.rank(start)); // enqueue weight of 0 with starting vertex
+
+    while(!pq.empty()) {
+        uint32_t curr = ws.actorOfRank(pq.pop().second);
+
+        if(curr == end) break; // end djikstra's when finding the end node
+
+        if(ws.done(curr)) continue;
+        ws.setDone(curr);
+        int dist = ws.dist(curr);
+
+        graph.forEachEdge(curr, ws, [&](uint32_t next, int weight, uint32_t movie) {
+            int total_dist = dist + weight;
+
+            if(total_dist < ws.dist(next)) {
+                ws.setPrev(next, curr, movie);
+                ws.setDist(next, total_dist);
+                pq.push(total_dist, ws.rank(next));
+            }
+        });
+    }
+}
+
+/**Function to implement A* with landmark bounds (ALT)
+ * Purpose: Finds the path dijkstra() finds while settling far fewer actors.
+ *      The queue is ordered by distance plus the landmark lower bound to
+ *      end, which never overestimates and is consistent.  A* settles in a
+ *      different order than dijkstra, so of two equally short ways to an
+ *      actor it keeps the prev dijkstra would settle first, the one of lower
+ *      (dist, rank), and it goes on until every actor that can be on a
+ *      shortest path to end is settled.  For the same reason a movie is
+ *      expanded again by an actor of lower (dist, rank) than the one that
+ *      expanded it first
+ * Inputs: The adjacency to search, the workspace of this thread reset for
+ *      this search, the heap, the landmark table and the ids of two actors **/
+template<class Graph>
+void astar(const Graph& graph, SearchWorkspace& ws, HeapQueue& pq, const Landmarks& landmarks,
+           uint32_t start, uint32_t end) {
+    pq.clear();
+    int bound = landmarks.lowerBound(start, end);
+    if(bound == INT_MAX) return; // no path, dist of end stays infinity
+
+    ws.setDist(start, 0);
+    pq.push(bound, ws.rank(start));
+    int length = INT_MAX; // dist of end once settled
+
+    while(!pq.empty()) {
+        pair<int, uint32_t> top = pq.pop();
+        if(top.first > length) break; // the rest is longer than the path
+
+        uint32_t curr = ws.actorOfRank(top.second);
+        if(ws.done(curr)) continue;
+        ws.setDone(curr);
+        int dist = ws.dist(curr);
+
+        if(curr == end) {
+            length = dist;
+            continue;
+        }
+
+        ws.setExpander(dist, curr);
+        graph.forEachEdge(curr, ws, [&](uint32_t next, int weight, uint32_t movie) {
+            int total_dist = dist + weight;
+            int next_dist = ws.dist(next);
+            if(total_dist > next_dist) return;
+
+            if(total_dist == next_dist) { // as short, keep the lower (dist, rank)
+                uint32_t prev = ws.prev(next);
+                int prev_dist = ws.dist(prev);
+                if(dist < prev_dist || (dist == prev_dist && ws.rank(curr) < ws.rank(prev))) {
+                    ws.setPrev(next, curr, movie);
+                }
+                return;
+            }
+
+            int next_bound = landmarks.lowerBound(next, end);
+            if(next_bound == INT_MAX) return; // end cannot be reached from next
+
+            ws.setPrev(next, curr, movie);
+            ws.setDist(next, total_dist);
+            pq.push(total_dist + next_bound, ws.rank(next));
+        });
+    }
+}
+
+/**Function to pick the landmarks of ALT
+ * Purpose: Farthest point selection: the first landmark is the actor
+ *      farthest from seed, every next one the actor farthest from all
+ *      landmarks picked so far, among the actors they reach.  Stops early
+ *      once every reached actor is a landmark.  Fills landmarks with the
+ *      exact distance of every actor from each landmark
+ * Inputs: The adjacency to search, a workspace and heap to search with, how
+ *      many landmarks to pick, the actor to start from and the table **/
+template<class Graph>
+void selectLandmarks(const Graph& graph, SearchWorkspace& ws, HeapQueue& pq, uint32_t count,
+                     uint32_t seed, Landmarks& landmarks) {
+    uint32_t num_actors = graph.numNodes();
+    vector<uint32_t> chosen;
+    vector<vector<int>> rows;
+    vector<int> nearest(num_actors, INT_MAX); // distance to the closest landmark
+
+    ws.reset();
+    dijkstra(graph, ws, pq, seed, NO_ID); // no end, settle everything
+    uint32_t next = seed;
+    for(uint32_t a = 0; a < num_actors; a++) {
+        int d = ws.dist(a);
+        if(d != INT_MAX && d > ws.dist(next)) next = a;
+    }
+
+    while(chosen.size() < count) {
+        chosen.push_back(next);
+        rows.emplace_back(num_actors);
+        vector<int>& row = rows.back();
+
+        ws.reset();
+        dijkstra(graph, ws, pq, next, NO_ID);
+        for(uint32_t a = 0; a < num_actors; a++) {
+            row[a] = ws.dist(a);
+            nearest[a] = min(nearest[a], row[a]);
+        }
+
+        // the reached actor farthest from every landmark, lowest id on ties
+        next = NO_ID;
+        for(uint32_t a = 0; a < num_actors; a++) {
+            if(nearest[a] != INT_MAX && nearest[a] > 0 &&
+               (next == NO_ID || nearest[a] > nearest[next])) {
+                next = a;
+            }
+        }
+        if(next == NO_ID) break;
+    }
+
+    vector<int> table((uint64_t) num_actors * chosen.size());
+    for(uint32_t a = 0; a < num_actors; a++) {
+        for(size_t i = 0; i < chosen.size(); i++) {
+            table[(uint64_t) a * chosen.size() + i] = rows[i][a];
+        }
+    }
+    landmarks.assign(chosen, table);
+}
+
+/**Function to grow a shortest path tree with dijkstra's algorithm
+ * Purpose: Searches from start like dijkstra() but only stops once every
+ *      actor of targets (sorted) is settled, and lists the settled actors in
+ *      settled.  Settling more actors does not change the prev of any of
+ *      them, so every path in the tree is the one dijkstra() would find.
+ *      Returns true if every actor reachable from start was settled **/
+template<class Graph, class Queue>
+bool dijkstraTree(const Graph& graph, SearchWorkspace& ws, Queue& pq, uint32_t start,
+                  const vector<uint32_t>& targets, vector<uint32_t>& settled) {
+    pq.clear();
+    settled.clear();
+    size_t remaining = targets.size();
+
+    ws.setDist(start, 0);
+    pq.push(0, ws.rank(start));
+
+    while(!pq.empty()) {
+        uint32_t curr = ws.actorOfRank(pq.pop().second);
+
+        if(ws.done(curr)) continue;
+        ws.setDone(curr);
+        int dist = ws.dist(curr);
+        settled.push_back(curr);
+
+        if(binary_search(targets.begin(), targets.end(), curr) && --remaining == 0) {
+            return false; // every target has its path
+        }
+
+        graph.forEachEdge(curr, ws, [&](uint32_t next, int weight, uint32_t movie) {
+            int total_dist = dist + weight;
+
+            if(total_dist < ws.dist(next)) {
+                ws.setPrev(next, curr, movie);
+                ws.setDist(next, total_dist);
+                pq.push(total_dist, ws.rank(next));
+            }
+        });
+    }
+    return true;
+}
+
+/**Function to grow a shortest path tree with a BFS for unit weights
+ * Purpose: Does what dijkstraTree() does with unit weights, without the
+ *      queue.  Every level is expanded in order of actor rank and an actor
+ *      keeps the first prev that finds it, which is the one dijkstra would
+ *      settle first, so the paths are the same **/
+template<class Graph>
+bool bfsTree(const Graph& graph, SearchWorkspace& ws, uint32_t start,
+             const vector<uint32_t>& targets, vector<uint32_t>& settled) {
+    settled.assign(1, start);
+    size_t remaining = targets.size();
+    ws.setDist(start, 0);
+    if(binary_search(targets.begin(), targets.end(), start) && --remaining == 0) {
+        return false;
+    }
+
+    for(size_t level = 0; level < settled.size(); ) {
+        size_t level_end = settled.size();
+        sort(settled.begin() + level, settled.end(),
+             [&](uint32_t a, uint32_t b) { return ws.rank(a) < ws.rank(b); });
+
+        for(size_t i = level; i < level_end; i++) {
+            uint32_t curr = settled[i];
+            int dist = ws.dist(curr) + 1;
+
+            graph.forEachEdge(curr, ws, [&](uint32_t next, int, uint32_t movie) {
+                if(ws.dist(next) != INT_MAX) return;
+
+                ws.setDist(next, dist);
+                ws.setPrev(next, curr, movie);
+                settled.push_back(next);
+                if(binary_search(targets.begin(), targets.end(), next)) remaining--;
+            });
+            if(remaining == 0) return false; // every target has its path
+        }
+        level = level_end;
+    }
+    return true;
+}
+
+/**Function to implement a bidirectional BFS for unit weights
+ * Purpose: Grows a BFS ball around start in fwd and one around end in bwd,
+ *      always expanding the smaller frontier by a whole level, until they
+ *      meet.  Then leaves in fwd the path dijkstra would have found: the
+ *      prev of every actor on it is its lowest rank neighbor one step closer
+ *      to start.  dist of end is the length of the path, infinity if none
+ * Inputs: The adjacency to search, two workspaces reset for this search and
+ *      the ids of two actors **/
+template<class Graph>
+void bidirectionalBFS(const Graph& graph, SearchWorkspace& fwd, SearchWorkspace& bwd,
+                      uint32_t start, uint32_t end) {
+    vector<uint32_t> fwd_level(1, start); // actors fwd_depth steps from start
+    vector<uint32_t> bwd_level(1, end);   // actors bwd_depth steps from end
+    vector<uint32_t> next;
+    int fwd_depth = 0;
+    int bwd_depth = 0;
+    int length = start == end ? 0 : INT_MAX;
+
+    fwd.setDist(start, 0);
+    bwd.setDist(end, 0);
+
+    while(length == INT_MAX && !fwd_level.empty() && !bwd_level.empty()) {
+        bool forward = fwd_level.size() <= bwd_level.size();
+        SearchWorkspace& ws = forward ? fwd : bwd;
+        SearchWorkspace& other = forward ? bwd : fwd;
+        vector<uint32_t>& level = forward ? fwd_level : bwd_level;
+        int& depth = forward ? fwd_depth : bwd_depth;
+
+        // expand the whole level, the shortest path is the shortest meeting
+        next.clear();
+        for(uint32_t curr: level) {
+            graph.forEachEdge(curr, ws, [&](uint32_t next_actor, int, uint32_t) {
+                if(ws.dist(next_actor) != INT_MAX) return;
+
+                ws.setDist(next_actor, depth + 1);
+                next.push_back(next_actor);
+                int other_dist = other.dist(next_actor);
+                if(other_dist != INT_MAX && depth + 1 + other_dist < length) {
+                    length = depth + 1 + other_dist;
+                }
+            });
+        }
+        level.swap(next);
+        depth++;
+    }
+    if(length == INT_MAX) return; // the frontiers never met
+
+    // the distance from start of the actors on shortest paths beyond the
+    // forward ball: a neighbor is one step further along iff its distance
+    // to end is one less
+    for(int depth = fwd_depth; depth < length; depth++) {
+        next.clear();
+        for(uint32_t curr: fwd_level) {
+            if(bwd.dist(curr) != length - depth) continue;
+
+            graph.forEachEdge(curr, fwd, [&](uint32_t next_actor, int, uint32_t) {
+                if(fwd.dist(next_actor) == INT_MAX && bwd.dist(next_actor) == length - depth - 1) {
+                    fwd.setDist(next_actor, depth + 1);
+                    next.push_back(next_actor);
+                }
+            });
+        }
+        fwd_level.swap(next);
+    }
+
+    // walk back from end, always to the lowest rank actor one step closer
+    for(uint32_t curr = end; curr != start; curr = fwd.prev(curr)) {
+        int depth = fwd.dist(curr);
+        uint32_t prev = NO_ID;
+        uint32_t prev_rank = NO_ID;
+        uint32_t prev_movie = NO_ID;
+
+        bwd.reset(); // look at every movie of curr, not just unexpanded ones
+        graph.forEachEdge(curr, bwd, [&](uint32_t next_actor, int, uint32_t movie) {
+            uint32_t rank = fwd.rank(next_actor);
+            if(rank < prev_rank && fwd.dist(next_actor) == depth - 1) {
+                prev = next_actor;
+                prev_rank = rank;
+                prev_movie = movie;
+            }
+        });
+
+        fwd.setPrev(curr, prev, prev_movie);
+    }
+}
+
+/**Function to run the search of engine
+ * Purpose: Resets the workspaces of worker and leaves the path from start to
+ *      end in worker.ws, dist of end is infinity if there is none
+ * Inputs: The adjacency to search, the workspaces of this thread, the engine
+ *      and the ids of two actors **/
+template<class Graph>
+void findShortestPath(const Graph& graph, PathWorker& worker, SearchEngine engine,
+                      uint32_t start, uint32_t end) {
+    worker.ws.reset(); // forget the dist, prev and done of the previous query
+    if(engine == HEAP_DIJKSTRA) {
+        dijkstra(graph, worker.ws, worker.heap, start, end);
+    }
+    else if(engine == BUCKET_DIJKSTRA) {
+        dijkstra(graph, worker.ws, worker.buckets, start, end);
+    }
+    else if(engine == ALT_ASTAR) {
+        astar(graph, worker.ws, worker.heap, *worker.landmarks, start, end);
+    }
+    else {
+        worker.back_ws.reset();
+        bidirectionalBFS(graph, worker.ws, worker.back_ws, start, end);
+    }
+}
+/**Function to build the shortest path tree of start
+ * Purpose: Runs dijkstra on the queue of engine, or a BFS for unit weights,
+ *      until every actor of targets (sorted and unique) is settled and
+ *      returns the tree.  A* aims at a single end, ALT_ASTAR grows its trees
+ *      on the heap
+ * Inputs: The adjacency to search, the workspaces of this thread, the engine,
+ *      the starting actor and the actors the tree has to reach **/
+template<class Graph>
+shared_ptr<const PathTree> findPathTree(const Graph& graph, PathWorker& worker, SearchEngine engine,
+                                        uint32_t start, const vector<uint32_t>& targets) {
+    vector<uint32_t> settled;
+    bool complete;
+
+    worker.ws.reset();
+    if(engine == HEAP_DIJKSTRA || engine == ALT_ASTAR) {
+        complete = dijkstraTree(graph, worker.ws, worker.heap, start, targets, settled);
+    }
+    else if(engine == BUCKET_DIJKSTRA) {
+        complete = dijkstraTree(graph, worker.ws, worker.buckets, start, targets, settled);
+    }
+    else {
+        complete = bfsTree(graph, worker.ws, start, targets, settled);
+    }
+    return make_shared<const PathTree>(start, complete, worker.ws, settled);
+}
+#endif
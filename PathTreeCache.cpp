@@ -0,0 +1,105 @@
+/*
+ * File: PathTreeCache.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements the shortest path trees and their cache.  The cache
+ *      hands out shared pointers, so a tree evicted by one thread stays
+ *      valid for the threads still reading it.
+ */
+
+#include <algorithm>
+#include <climits>
+#include "PathTreeCache.h"
+
+using namespace std;
+
+/* Copies the distance and predecessor of the settled actors out of the
+ * workspace of the search that settled them.
+ */
+PathTree::PathTree(uint32_t source, bool complete, const SearchWorkspace& ws,
+                   const vector<uint32_t>& settled)
+    : actors(settled), source(source), complete(complete) {
+    sort(actors.begin(), actors.end());
+    dists.reserve(actors.size());
+    prevs.reserve(actors.size());
+    prev_movies.reserve(actors.size());
+    for(uint32_t actor: actors) {
+        dists.push_back(ws.dist(actor));
+        prevs.push_back(ws.prev(actor));
+        prev_movies.push_back(ws.prevMovie(actor));
+    }
+}
+
+// Returns the index of actor, or size() if it was not settled.
+size_t PathTree::find(uint32_t actor) const {
+    auto it = lower_bound(actors.begin(), actors.end(), actor);
+    if(it == actors.end() || *it != actor) return actors.size();
+    return it - actors.begin();
+}
+
+/* Leaves the path from source to end in ws the way findShortestPath()
+ * does: dist of end is the length, infinity if there is no path, and every
+ * actor on the path has its prev and prev_movie.  end must be covered.
+ */
+void PathTree::writePath(uint32_t end, SearchWorkspace& ws) const {
+    ws.reset();
+    size_t i = find(end);
+    if(i == actors.size()) return; // the complete tree does not reach end
+
+    ws.setDist(end, dists[i]);
+    for(uint32_t curr = end; curr != source; curr = prevs[i]) {
+        i = find(curr);
+        ws.setPrev(curr, prevs[i], prev_movies[i]);
+    }
+}
+
+PathTreeCache::PathTreeCache(size_t capacity) : capacity(capacity), num_hits(0), num_misses(0) {}
+
+/* Returns the cached tree of source if it covers every actor of targets and
+ * marks it as most recently used, otherwise returns null.
+ */
+shared_ptr<const PathTree> PathTreeCache::get(uint32_t source, const vector<uint32_t>& targets) {
+    lock_guard<mutex> guard(lock);
+    auto it = by_source.find(source);
+    if(it != by_source.end()) {
+        const PathTree& tree = **it->second;
+        bool covered = all_of(targets.begin(), targets.end(),
+                              [&](uint32_t actor) { return tree.covers(actor); });
+        if(covered) {
+            entries.splice(entries.begin(), entries, it->second);
+            num_hits++;
+            return entries.front();
+        }
+    }
+    num_misses++;
+    return nullptr;
+}
+
+/* Adds tree as the most recently used, replacing the tree of the same
+ * source and evicting the least recently used one if the cache is full.
+ */
+void PathTreeCache::put(const shared_ptr<const PathTree>& tree) {
+    lock_guard<mutex> guard(lock);
+    if(capacity == 0) return;
+
+    auto it = by_source.find(tree->source);
+    if(it != by_source.end()) {
+        entries.erase(it->second);
+        by_source.erase(it);
+    }
+    else if(entries.size() == capacity) {
+        by_source.erase(entries.back()->source);
+        entries.pop_back();
+    }
+    entries.push_front(tree);
+    by_source[tree->source] = entries.begin();
+}
+
+uint64_t PathTreeCache::hits() const {
+    lock_guard<mutex> guard(lock);
+    return num_hits;
+}
+
+uint64_t PathTreeCache::misses() const {
+    lock_guard<mutex> guard(lock);
+    return num_misses;
+}
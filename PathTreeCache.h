@@ -0,0 +1,72 @@
+/*
+ * File: PathTreeCache.h
+ * Date: December 4, 2017
+ * Purpose: Declares the shortest path tree of one starting actor and a
+ *      least recently used cache of them.  A tree holds the actors a search
+ *      settled with their distance and predecessor, sorted by actor, so it
+ *      answers every pair of its start that ends in it without searching
+ *      again.  The cache is shared by the threads answering pairs and
+ *      counts its hits and misses so its size can be tuned.
+ */
+
+#ifndef PATHTREECACHE_H
+#define PATHTREECACHE_H
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "ActorNode.h"
+#include "SearchWorkspace.h"
+using namespace std;
+
+class PathTree
+{
+    private:
+        vector<uint32_t> actors; // settled actors in increasing id
+        vector<int> dists;
+        vector<uint32_t> prevs;
+        vector<uint32_t> prev_movies;
+
+        size_t find(uint32_t actor) const;
+
+    public:
+        const uint32_t source;
+        const bool complete; // every actor reachable from source was settled
+
+        PathTree(uint32_t source, bool complete, const SearchWorkspace& ws,
+                 const vector<uint32_t>& settled);
+
+        size_t size() const { return actors.size(); }
+
+        // True if the path from source to actor, or that there is none, is known.
+        bool covers(uint32_t actor) const { return complete || find(actor) != actors.size(); }
+
+        void writePath(uint32_t end, SearchWorkspace& ws) const;
+};
+
+class PathTreeCache
+{
+    private:
+        typedef list<shared_ptr<const PathTree>> Entries;
+
+        Entries entries; // most recently used first
+        unordered_map<uint32_t, Entries::iterator> by_source;
+        size_t capacity;
+        uint64_t num_hits;
+        uint64_t num_misses;
+        mutable mutex lock;
+
+    public:
+        PathTreeCache(size_t capacity);
+
+        shared_ptr<const PathTree> get(uint32_t source, const vector<uint32_t>& targets);
+
+        void put(const shared_ptr<const PathTree>& tree);
+
+        uint64_t hits() const;
+
+        uint64_t misses() const;
+};
+#endif
@@ -0,0 +1,47 @@
+/* 
+ * File: SearchQueue.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the bucket queue.  With weights of at least 1 nothing
+ *      is pushed into the bucket being popped, so it can be sorted once when
+ *      it becomes current to pop its actors in order of id.
+ */
+
+#include <algorithm>
+#include "SearchQueue.h"
+
+using namespace std;
+
+// Constructor, call init() before the first push
+BucketQueue::BucketQueue(void) : curr_pos(0), curr_dist(-1), count(0) {}
+
+// Makes room for edge weights from 1 up to max_weight.
+void BucketQueue::init(int max_weight) {
+    buckets.assign(max_weight + 1, vector<uint32_t>());
+    clear();
+}
+
+// Empties the queue for a new search, keeping the memory of the buckets.
+void BucketQueue::clear() {
+    if(count > 0) { // a search that stopped early left actors behind
+        for(auto& b: buckets) {
+            b.clear();
+        }
+    }
+    curr.clear();
+    curr_pos = 0;
+    curr_dist = -1;
+    count = 0;
+}
+
+// Removes the actor with the smallest distance, ties broken by lowest id.
+pair<int, uint32_t> BucketQueue::pop() {
+    while(curr_pos == curr.size()) { // move on to the next non-empty bucket
+        curr.clear();
+        curr_pos = 0;
+        curr_dist++;
+        curr.swap(buckets[curr_dist % buckets.size()]);
+        sort(curr.begin(), curr.end());
+    }
+    count--;
+    return make_pair(curr_dist, curr[curr_pos++]);
+}
@@ -0,0 +1,69 @@
+/* 
+ * File: SearchQueue.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the priority queues dijkstra can run on.  Both pop
+ *      (distance, actor) pairs in increasing order of distance and then of
+ *      actor, so the engines settle actors in the same order and give the
+ *      same paths.  The searches push the rank of an actor, see
+ *      SearchWorkspace::rank().  HeapQueue is a plain binary heap and works for any
+ *      weights.  BucketQueue is a Dial bucket queue for integer weights
+ *      between 1 and a known maximum, with O(1) push and amortized pop.
+ */
+
+#ifndef SEARCHQUEUE_H
+#define SEARCHQUEUE_H
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+using namespace std;
+
+class HeapQueue
+{
+    private:
+        priority_queue<pair<int, uint32_t>, vector<pair<int, uint32_t>>,
+                       greater<pair<int, uint32_t>>> heap;
+
+    public:
+        void clear() { heap = decltype(heap)(); }
+
+        bool empty() const { return heap.empty(); }
+
+        void push(int dist, uint32_t actor) { heap.push(make_pair(dist, actor)); }
+
+        pair<int, uint32_t> pop() {
+            pair<int, uint32_t> top = heap.top();
+            heap.pop();
+            return top;
+        }
+};
+
+class BucketQueue
+{
+    private:
+        // bucket d % buckets.size() holds the actors pushed with distance d,
+        // every pending distance is within max_weight of the current one
+        vector<vector<uint32_t>> buckets;
+        vector<uint32_t> curr; // bucket of curr_dist, sorted by actor id
+        size_t curr_pos;
+        int curr_dist;
+        size_t count;          // pushed and not popped yet
+
+    public:
+        BucketQueue(void);
+
+        void init(int max_weight);
+
+        void clear();
+
+        bool empty() const { return count == 0; }
+
+        void push(int dist, uint32_t actor) {
+            buckets[dist % buckets.size()].push_back(actor);
+            count++;
+        }
+
+        pair<int, uint32_t> pop();
+};
+#endif
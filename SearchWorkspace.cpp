@@ -0,0 +1,47 @@
+/* 
+ * File: SearchWorkspace.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the per-search scratch state.  Every entry is stamped
+ *      with the search that wrote it, which makes starting a new search O(1).
+ */
+
+#include <algorithm>
+#include "SearchWorkspace.h"
+
+using namespace std;
+
+// Constructor, call resize() before the first search
+SearchWorkspace::SearchWorkspace(void) : expander(0), epoch(2), rank_of(nullptr), actor_of(nullptr) {}
+
+// Makes room for a graph of num_actors actors and num_movies movies.
+void SearchWorkspace::resize(uint32_t num_actors, uint32_t num_movies) {
+    hot.assign(num_actors, HotState{0, INT_MAX});
+    links.assign(num_actors, PathLink{NO_ID, NO_ID});
+    movie_epoch.assign(num_movies, 0);
+    movie_expander.assign(num_movies, 0);
+    expander = 0;
+    epoch = 2;
+}
+
+/* Breaks ties by rank_of instead of the ids, actor_of is its inverse.  Both
+ * null, the default, when the actors were never renumbered.
+ */
+void SearchWorkspace::setRanks(const uint32_t* rank_of, const uint32_t* actor_of) {
+    this->rank_of = rank_of;
+    this->actor_of = actor_of;
+}
+
+/* Starts a new search.  Epochs go up by two to leave room for the settled
+ * bit, only when they wrap are the stamps cleared.
+ */
+void SearchWorkspace::reset() {
+    expander = 0;
+    epoch += 2;
+    if(epoch == 0) { // wrapped around, old stamps could match again
+        for(auto& h: hot) {
+            h.stamp = 0;
+        }
+        fill(movie_epoch.begin(), movie_epoch.end(), 0);
+        epoch = 2;
+    }
+}
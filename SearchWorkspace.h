@@ -0,0 +1,124 @@
+/* 
+ * File: SearchWorkspace.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the scratch state of a single search: the distance,
+ *      predecessor and settled flag of every actor and the movies the search
+ *      has expanded.  Keeping it out of the graph leaves the graph read-only
+ *      while searching, so every thread can run its own searches on it with
+ *      a workspace of its own.  The fields are kept in parallel arrays
+ *      indexed by actor: the distance and the stamp every relaxation reads
+ *      share one small entry, the predecessors that are only written on an
+ *      improvement and read back along the path live apart from them.
+ *      Ties between equally short paths go by the rank of an actor, its id
+ *      before ActorGraph::reorder() renumbered the actors, so a renumbered
+ *      graph gives the same paths as the original one.
+ */
+
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "ActorNode.h"
+using namespace std;
+
+class SearchWorkspace
+{
+    private:
+        /* The fields every relaxation reads, 8 bytes per actor.  stamp is
+         * the epoch of the search that wrote dist, plus one once the actor
+         * is settled, so an actor with an older stamp is unreached.
+         */
+        struct HotState
+        {
+            uint32_t stamp;
+            int dist;
+        };
+
+        // The way the path reaches an actor, only written on an improvement.
+        struct PathLink
+        {
+            uint32_t prev;  // actor before this one on the path, NO_ID if none
+            uint32_t movie; // movie on the edge prev -> this actor
+        };
+
+        vector<HotState> hot;
+        vector<PathLink> links;
+        vector<uint32_t> movie_epoch; // movies stamped with epoch were expanded
+        vector<uint64_t> movie_expander; // expander key of the last expansion
+        uint64_t expander; // (dist, rank) key of the actor expanding, see setExpander()
+        uint32_t epoch;    // always even, see reset()
+        const uint32_t* rank_of;  // rank of every actor, null while the ids are the ranks
+        const uint32_t* actor_of; // actor of every rank
+
+        bool current(uint32_t actor) const { return (hot[actor].stamp & ~1u) == epoch; }
+
+        /* Makes actor part of the current search.  An actor last touched by
+         * an earlier search is reset here, so reset() does not have to visit
+         * every actor and reading an actor never writes to it.
+         */
+        void touch(uint32_t actor) {
+            if(!current(actor)) {
+                hot[actor] = HotState{epoch, INT_MAX};
+                links[actor] = PathLink{NO_ID, NO_ID};
+            }
+        }
+
+    public:
+        SearchWorkspace(void);
+
+        void resize(uint32_t num_actors, uint32_t num_movies);
+
+        void reset();
+
+        void setRanks(const uint32_t* rank_of, const uint32_t* actor_of);
+
+        // Id of actor before the actors were renumbered, ties go by it.
+        uint32_t rank(uint32_t actor) const { return rank_of == nullptr ? actor : rank_of[actor]; }
+
+        uint32_t actorOfRank(uint32_t rank) const { return actor_of == nullptr ? rank : actor_of[rank]; }
+
+        // Distance of actor from the start, INT_MAX while unreached.
+        int dist(uint32_t actor) const { return current(actor) ? hot[actor].dist : INT_MAX; }
+
+        // True once the search settled actor.
+        bool done(uint32_t actor) const { return hot[actor].stamp == epoch + 1; }
+
+        // Actor before this one on the path and the movie between them.
+        uint32_t prev(uint32_t actor) const { return current(actor) ? links[actor].prev : NO_ID; }
+
+        uint32_t prevMovie(uint32_t actor) const { return current(actor) ? links[actor].movie : NO_ID; }
+
+        void setDist(uint32_t actor, int dist) {
+            touch(actor);
+            hot[actor].dist = dist;
+        }
+
+        void setDone(uint32_t actor) {
+            touch(actor);
+            hot[actor].stamp = epoch + 1;
+        }
+
+        void setPrev(uint32_t actor, uint32_t prev, uint32_t prev_movie) {
+            touch(actor);
+            links[actor] = PathLink{prev, prev_movie};
+        }
+
+        /* Tells expandMovie() which actor expands the next movies.  A search
+         * that does not settle in order of (dist, rank), like A*, has to
+         * expand a movie again from an actor of lower (dist, rank).
+         */
+        void setExpander(int dist, uint32_t actor) {
+            expander = (uint64_t) (uint32_t) dist << 32 | rank(actor);
+        }
+
+        // Marks movie as expanded, returns false if this search already did
+        // from an actor of at most the same (dist, rank).
+        bool expandMovie(uint32_t movie) {
+            if(movie_epoch[movie] == epoch && expander >= movie_expander[movie]) return false;
+            movie_epoch[movie] = epoch;
+            movie_expander[movie] = expander;
+            return true;
+        }
+};
+#endif
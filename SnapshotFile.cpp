@@ -0,0 +1,179 @@
+/* 
+ * File: SnapshotFile.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements writing, validating and mapping graph snapshots.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "SnapshotFile.h"
+
+using namespace std;
+
+static const char SNAPSHOT_MAGIC[8] = { 'A', 'C', 'T', 'G', 'R', 'A', 'P', 'H' };
+static const uint64_t SNAPSHOT_ALIGN = 64;
+
+static uint64_t alignUp(uint64_t offset) {
+    return (offset + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+}
+
+static uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+/* 64-bit hash of a buffer, four independent lanes of 8 bytes so that
+ * verifying a large snapshot runs close to memory bandwidth.  Chaining calls
+ * through seed hashes several buffers as one.
+ */
+uint64_t SnapshotReader::checksum(const char* data, uint64_t size, uint64_t seed) {
+    const uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+    uint64_t lanes[4] = { seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 };
+    uint64_t i = 0;
+
+    for(; i + 32 <= size; i += 32) {
+        for(int l = 0; l < 4; l++) {
+            uint64_t word;
+            memcpy(&word, data + i + 8 * l, 8);
+            lanes[l] = rotl64(lanes[l] + word * PRIME2, 31) * PRIME1;
+        }
+    }
+
+    uint64_t hash = rotl64(lanes[0], 1) + rotl64(lanes[1], 7) +
+                    rotl64(lanes[2], 12) + rotl64(lanes[3], 18);
+    for(; i < size; i++) {
+        hash = (hash ^ (unsigned char) data[i]) * PRIME1;
+    }
+
+    hash ^= size;
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+/* Hash of every field of header but the checksum itself, the seed of the
+ * checksum of the rest of the file.
+ */
+uint64_t SnapshotReader::headerChecksum(const SnapshotHeader& header) {
+    SnapshotHeader copy = header;
+    copy.checksum = 0;
+    return checksum(reinterpret_cast<const char*>(&copy), sizeof(copy), 0);
+}
+
+/* Lays the sections out, then writes the snapshot to a temporary file that
+ * is renamed over filename only once it is complete.
+ */
+bool SnapshotWriter::write(const char* filename, uint32_t flags) {
+    uint64_t offset = alignUp(sizeof(SnapshotHeader) + sections.size() * sizeof(SnapshotSection));
+    for(auto& s: sections) {
+        s.offset = offset;
+        offset = alignUp(offset + s.count * s.elem_size);
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SnapshotReader::VERSION;
+    header.flags = flags;
+    header.num_sections = sections.size();
+    header.file_size = offset;
+    header.checksum = SnapshotReader::checksum(reinterpret_cast<const char*>(sections.data()),
+                                               sections.size() * sizeof(SnapshotSection),
+                                               SnapshotReader::headerChecksum(header));
+    for(unsigned i = 0; i < sections.size(); i++) {
+        header.checksum = SnapshotReader::checksum(payloads[i], sections[i].count * sections[i].elem_size,
+                                                   header.checksum);
+    }
+
+    string tmp_name = string(filename) + ".tmp";
+    ofstream out(tmp_name, ios::binary | ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(sections.data()), sections.size() * sizeof(SnapshotSection));
+
+    static const char zeros[SNAPSHOT_ALIGN] = {};
+    uint64_t written = sizeof(header) + sections.size() * sizeof(SnapshotSection);
+    for(unsigned i = 0; i < sections.size(); i++) {
+        out.write(zeros, sections[i].offset - written);
+        out.write(payloads[i], sections[i].count * sections[i].elem_size);
+        written = sections[i].offset + sections[i].count * sections[i].elem_size;
+    }
+    out.write(zeros, header.file_size - written);
+    out.close();
+
+    if(!out || rename(tmp_name.c_str(), filename) != 0) {
+        remove(tmp_name.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Constructor, the mapping is owned by the caller so views outlive the reader
+SnapshotReader::SnapshotReader(MappedFile& file) : file(file), header(nullptr), sections(nullptr) {}
+
+/* Maps filename and checks magic, version, layout and checksum.  On failure
+ * error says why and the reader must not be used.
+ */
+bool SnapshotReader::open(const char* filename, string& error) {
+    if(!file.open(filename)) {
+        error = "cannot open file";
+        return false;
+    }
+    if(file.size() < sizeof(SnapshotHeader)) {
+        error = "file is too small";
+        return false;
+    }
+
+    header = reinterpret_cast<const SnapshotHeader*>(file.data());
+    if(memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        error = "not a graph snapshot";
+        return false;
+    }
+    if(header->version != VERSION) {
+        error = "unsupported snapshot version " + to_string(header->version);
+        return false;
+    }
+    if(header->file_size != file.size() ||
+       header->num_sections > (file.size() - sizeof(SnapshotHeader)) / sizeof(SnapshotSection)) {
+        error = "file is truncated";
+        return false;
+    }
+
+    sections = reinterpret_cast<const SnapshotSection*>(file.data() + sizeof(SnapshotHeader));
+    uint64_t hash = checksum(reinterpret_cast<const char*>(sections),
+                             header->num_sections * sizeof(SnapshotSection), headerChecksum(*header));
+
+    for(uint64_t i = 0; i < header->num_sections; i++) {
+        const SnapshotSection& s = sections[i];
+        if(s.elem_size == 0 || s.offset % SNAPSHOT_ALIGN != 0 || s.offset > file.size() ||
+           s.count > (file.size() - s.offset) / s.elem_size) {
+            error = "section " + to_string(s.id) + " is out of bounds";
+            return false;
+        }
+        hash = checksum(file.data() + s.offset, s.count * s.elem_size, hash);
+    }
+
+    if(hash != header->checksum) {
+        error = "checksum mismatch";
+        return false;
+    }
+    return true;
+}
+
+// Returns the section with the given id if its elements have elem_size bytes.
+const SnapshotSection* SnapshotReader::find(uint32_t id, uint32_t elem_size) const {
+    for(uint64_t i = 0; i < header->num_sections; i++) {
+        if(sections[i].id == id) {
+            return sections[i].elem_size == elem_size ? &sections[i] : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+bool SnapshotReader::has(uint32_t id) const {
+    for(uint64_t i = 0; i < header->num_sections; i++) {
+        if(sections[i].id == id) return true;
+    }
+    return false;
+}
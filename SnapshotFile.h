@@ -0,0 +1,127 @@
+/* 
+ * File: SnapshotFile.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the reader and writer of binary graph snapshots.  A
+ *      snapshot is a header, a table of typed sections and the raw section
+ *      data, each section aligned to 64 bytes so it can be used in place
+ *      once the file is mapped.  The file is in native byte order.
+ */
+
+#ifndef SNAPSHOTFILE_H
+#define SNAPSHOTFILE_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FlatArray.h"
+#include "MappedFile.h"
+using namespace std;
+
+// section ids, new ids may be added but existing ones must never change
+enum SnapshotSectionId : uint32_t
+{
+    SNAP_STRING_BYTES = 1,
+    SNAP_STRING_OFFSETS,
+    SNAP_STRING_HASHES,
+    SNAP_STRING_SLOTS,
+    SNAP_ACTOR_NAMES,
+    SNAP_ACTOR_OF_NAME,
+    SNAP_MOVIE_OF_NAME,
+    SNAP_MOVIE_NAMES,
+    SNAP_MOVIE_YEARS,
+    SNAP_MOVIE_WEIGHTS,
+    SNAP_CAST_OFFSETS,
+    SNAP_CAST_ACTORS,
+    SNAP_CSR_OFFSETS,
+    SNAP_CSR_TARGETS,
+    SNAP_CSR_WEIGHTS,
+    SNAP_CSR_MOVIES,
+    SNAP_BIP_ACTOR_OFFSETS,
+    SNAP_BIP_ACTOR_MOVIES,
+    SNAP_CONN_PARENTS,
+    SNAP_CONN_YEARS,
+    SNAP_CONN_FIRST_YEAR,
+    SNAP_LANDMARK_ACTORS,
+    SNAP_LANDMARK_DISTS,
+    SNAP_ACTOR_RANKS
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;        // meaning is up to the owner of the snapshot
+    uint64_t num_sections;
+    uint64_t checksum;     // of this header with checksum 0, the section table and the data
+    uint64_t file_size;
+};
+
+struct SnapshotSection
+{
+    uint32_t id;
+    uint32_t elem_size;
+    uint64_t offset;
+    uint64_t count;
+};
+
+class SnapshotWriter
+{
+    private:
+        vector<SnapshotSection> sections;
+        vector<const char*> payloads;
+
+    public:
+        template<class T>
+        void add(uint32_t id, const T* data, uint64_t count) {
+            sections.push_back(SnapshotSection{id, (uint32_t) sizeof(T), 0, count});
+            payloads.push_back(reinterpret_cast<const char*>(data));
+        }
+
+        template<class T>
+        void add(uint32_t id, const FlatArray<T>& array) {
+            add(id, array.data(), array.size());
+        }
+
+        template<class T>
+        void add(uint32_t id, const vector<T>& array) {
+            add(id, array.data(), array.size());
+        }
+
+        bool write(const char* filename, uint32_t flags);
+};
+
+class SnapshotReader
+{
+    private:
+        MappedFile& file;
+        const SnapshotHeader* header;
+        const SnapshotSection* sections;
+
+        const SnapshotSection* find(uint32_t id, uint32_t elem_size) const;
+
+    public:
+        SnapshotReader(MappedFile& file);
+
+        bool open(const char* filename, string& error);
+
+        uint32_t flags() const { return header->flags; }
+
+        bool has(uint32_t id) const;
+
+        /* Points array at the data of section id.  Returns false if the
+         * section is missing or its elements are not of type T.
+         */
+        template<class T>
+        bool get(uint32_t id, FlatArray<T>& array) const {
+            const SnapshotSection* section = find(id, sizeof(T));
+            if(section == nullptr) return false;
+            array.view(reinterpret_cast<const T*>(file.data() + section->offset), section->count);
+            return true;
+        }
+
+        static const uint32_t VERSION = 2;
+
+        static uint64_t checksum(const char* data, uint64_t size, uint64_t seed);
+
+        static uint64_t headerChecksum(const SnapshotHeader& header);
+};
+#endif
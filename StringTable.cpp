@@ -0,0 +1,99 @@
+/* 
+ * File: StringTable.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the interned string table.  The hash is FNV-1a so that
+ *      it does not depend on the standard library in use.
+ */
+
+#include "StringTable.h"
+
+using namespace std;
+
+// Constructor, starts with a small power of two table
+StringTable::StringTable(void) : offsets(1, 0), slots(16, NONE) {}
+
+// FNV-1a hash of the characters of a string.
+uint32_t StringTable::hashString(string_view str) {
+    uint32_t hash = 2166136261u;
+    for(char c: str) {
+        hash ^= (unsigned char) c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* Returns the slot holding str, or the empty slot where it would be
+ * inserted.  The table is never full so the probe always terminates.
+ */
+uint32_t StringTable::findSlot(string_view str, uint32_t hash) const {
+    uint32_t mask = slots.size() - 1;
+    uint32_t slot = hash & mask;
+
+    while(slots[slot] != NONE) {
+        uint32_t id = slots[slot];
+        if(hashes[id] == hash && get(id) == str) break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+// Doubles the hash table and reinserts every id using the stored hashes.
+void StringTable::grow() {
+    slots.assign(slots.size() * 2, NONE);
+    uint32_t mask = slots.size() - 1;
+
+    for(uint32_t id = 0; id < hashes.size(); id++) {
+        uint32_t slot = hashes[id] & mask;
+        while(slots[slot] != NONE) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = id;
+    }
+}
+
+// Returns the id of str, copying it into the table if it is new.
+uint32_t StringTable::intern(string_view str) {
+    uint32_t hash = hashString(str);
+    uint32_t slot = findSlot(str, hash);
+    if(slots[slot] != NONE) {
+        return slots[slot];
+    }
+
+    uint32_t id = hashes.size();
+    bytes.append(str.begin(), str.end());
+    offsets.push_back(bytes.size());
+    hashes.push_back(hash);
+    slots[slot] = id;
+
+    if(hashes.size() * 2 > slots.size()) { // keep the load factor under 1/2
+        grow();
+    }
+    return id;
+}
+
+// Returns the id of str, or NONE if it was never interned.
+uint32_t StringTable::find(string_view str) const {
+    return slots[findSlot(str, hashString(str))];
+}
+
+// Adds the table and its hash index to a snapshot.
+void StringTable::save(SnapshotWriter& out) const {
+    out.add(SNAP_STRING_BYTES, bytes);
+    out.add(SNAP_STRING_OFFSETS, offsets);
+    out.add(SNAP_STRING_HASHES, hashes);
+    out.add(SNAP_STRING_SLOTS, slots);
+}
+
+/* Uses the table stored in a snapshot in place.  Returns false if it is
+ * missing or inconsistent.
+ */
+bool StringTable::load(const SnapshotReader& in) {
+    if(!in.get(SNAP_STRING_BYTES, bytes) || !in.get(SNAP_STRING_OFFSETS, offsets) ||
+       !in.get(SNAP_STRING_HASHES, hashes) || !in.get(SNAP_STRING_SLOTS, slots)) {
+        return false;
+    }
+
+    size_t num_slots = slots.size();
+    return offsets.size() == hashes.size() + 1 && offsets.back() == bytes.size() &&
+           num_slots >= 2 * hashes.size() && num_slots > 0 && (num_slots & (num_slots - 1)) == 0;
+}
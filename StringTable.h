@@ -0,0 +1,51 @@
+/* 
+ * File: StringTable.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the interned string table of the graph.  Every actor
+ *      name and every title#@year key is stored once in a single character
+ *      buffer and referred to everywhere else by a dense uint32_t id.  Lookup
+ *      by name is an open addressing hash on the characters themselves.
+ */
+
+#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+#include <cstdint>
+#include <string_view>
+#include "FlatArray.h"
+#include "SnapshotFile.h"
+using namespace std;
+
+class StringTable
+{
+    private:
+        FlatArray<char> bytes;        // all strings back to back
+        FlatArray<uint64_t> offsets;  // string i is bytes[offsets[i], offsets[i+1])
+        FlatArray<uint32_t> hashes;   // hash of every string, used to skip compares
+        FlatArray<uint32_t> slots;    // open addressing table of string ids
+
+        uint32_t findSlot(string_view str, uint32_t hash) const;
+
+        void grow();
+
+    public:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        StringTable(void);
+
+        static uint32_t hashString(string_view str);
+
+        uint32_t intern(string_view str);
+
+        uint32_t find(string_view str) const;
+
+        string_view get(uint32_t id) const {
+            return string_view(bytes.data() + offsets[id], offsets[id + 1] - offsets[id]);
+        }
+
+        uint32_t size() const { return hashes.size(); }
+
+        void save(SnapshotWriter& out) const;
+
+        bool load(const SnapshotReader& in);
+};
+#endif
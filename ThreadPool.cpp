@@ -0,0 +1,104 @@
+/* 
+ * File: ThreadPool.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the worker pool.  The calling thread takes part in
+ *      every parallelFor as worker 0, so a pool of size 1 spawns no threads
+ *      and simply runs the loop inline.
+ */
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Constructor, spawns num_threads - 1 helpers next to the calling thread
+ThreadPool::ThreadPool(unsigned num_threads) : job(nullptr), task_count(0),
+                                               next_task(0), active(0),
+                                               generation(0), stopping(false) {
+    for(unsigned i = 1; i < num_threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+/* Claims task indices until none are left.  The first exception thrown by a
+ * task is kept and rethrown to the caller of parallelFor.
+ */
+void ThreadPool::runTasks(unsigned worker) {
+    while(1) {
+        size_t task = next_task.fetch_add(1);
+        if(task >= task_count) break;
+
+        try {
+            (*job)(task, worker);
+        }
+        catch(...) {
+            lock_guard<mutex> guard(lock);
+            if(!error) error = current_exception();
+        }
+    }
+}
+
+// Body of every helper thread: wait for a new loop, help run it, report back.
+void ThreadPool::workerLoop(unsigned worker) {
+    uint64_t seen = 0;
+
+    while(1) {
+        {
+            unique_lock<mutex> guard(lock);
+            work_cv.wait(guard, [&] { return stopping || generation != seen; });
+            if(stopping) return;
+            seen = generation;
+        }
+
+        runTasks(worker);
+
+        lock_guard<mutex> guard(lock);
+        if(--active == 0) done_cv.notify_one();
+    }
+}
+
+/* Runs task(i, worker) for every i in [0, num_tasks) and returns once all of
+ * them have finished.
+ */
+void ThreadPool::parallelFor(size_t num_tasks, const Task& task) {
+    if(workers.empty() || num_tasks <= 1) {
+        for(size_t i = 0; i < num_tasks; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> guard(lock);
+        job = &task;
+        task_count = num_tasks;
+        next_task = 0;
+        active = workers.size();
+        error = nullptr;
+        generation++;
+    }
+    work_cv.notify_all();
+
+    runTasks(0);
+
+    unique_lock<mutex> guard(lock);
+    done_cv.wait(guard, [&] { return active == 0; });
+    job = nullptr;
+
+    if(error) {
+        exception_ptr failed = error;
+        error = nullptr;
+        rethrow_exception(failed);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    work_cv.notify_all();
+
+    for(auto& w: workers) {
+        w.join();
+    }
+}
@@ -0,0 +1,57 @@
+/* 
+ * File: ThreadPool.h
+ * Date: December 4, 2017  
+ * Purpose: Declares a small fixed-size pool of worker threads.  The only
+ *      operation is a blocking parallel for loop over task indices, which is
+ *      all the loaders and graph builders need.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class ThreadPool
+{
+    public:
+        // task index, index of the worker running it (0 is the calling thread)
+        typedef function<void(size_t, unsigned)> Task;
+
+    private:
+        vector<thread> workers;
+        mutex lock;
+        condition_variable work_cv;
+        condition_variable done_cv;
+        const Task* job;
+        size_t task_count;
+        atomic<size_t> next_task;
+        unsigned active;
+        uint64_t generation;
+        bool stopping;
+        exception_ptr error;
+
+        void runTasks(unsigned worker);
+
+        void workerLoop(unsigned worker);
+
+    public:
+        ThreadPool(unsigned num_threads);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned size() const { return workers.size() + 1; }
+
+        void parallelFor(size_t num_tasks, const Task& task);
+};
+#endif
@@ -0,0 +1,138 @@
+/*
+ * File: TsvScanner.cpp
+ * Date: December 4, 2017
+ * Purpose: Implements the delimiter kernels and picks the fastest one the
+ *      CPU runs.  The vector kernels turn every 64 byte block into a bit
+ *      mask of its delimiters and write the offsets of the set bits, the
+ *      last block shorter than 64 bytes goes through the byte loop.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TSV_X86 1
+#endif
+#include "TsvScanner.h"
+
+using namespace std;
+
+// Writes the offset of every set bit of mask, block is the offset of bit 0.
+static inline void emitBits(uint64_t mask, size_t block, uint32_t* out, size_t& count) {
+    while(mask != 0) {
+        out[count++] = block + __builtin_ctzll(mask);
+        mask &= mask - 1;
+    }
+}
+
+// The byte loop, used on its own where there are no vector instructions.
+static size_t scanScalar(const char* data, size_t begin, size_t end, uint32_t* out,
+                         size_t max_out, size_t& count) {
+    size_t i = begin;
+    for(; i < end && count < max_out; i++) {
+        if(data[i] == '\t' || data[i] == '\n') out[count++] = i;
+    }
+    return i;
+}
+
+#ifdef TSV_X86
+static uint64_t blockSSE2(const char* p) {
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for(int k = 0; k < 4; k++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, newline));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hits))) << (16 * k);
+    }
+    return mask;
+}
+
+static size_t scanSSE2(const char* data, size_t begin, size_t end, uint32_t* out,
+                       size_t max_out, size_t& count) {
+    size_t i = begin;
+    for(; end - i >= 64 && count + 64 <= max_out; i += 64) {
+        emitBits(blockSSE2(data + i), i, out, count);
+    }
+    return end - i < 64 ? scanScalar(data, i, end, out, max_out, count) : i;
+}
+
+__attribute__((target("avx2")))
+static uint64_t blockAVX2(const char* p) {
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    __m256i lo_hits = _mm256_or_si256(_mm256_cmpeq_epi8(lo, tab), _mm256_cmpeq_epi8(lo, newline));
+    __m256i hi_hits = _mm256_or_si256(_mm256_cmpeq_epi8(hi, tab), _mm256_cmpeq_epi8(hi, newline));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(lo_hits)) |
+           static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi_hits))) << 32;
+}
+
+__attribute__((target("avx2")))
+static size_t scanAVX2(const char* data, size_t begin, size_t end, uint32_t* out,
+                       size_t max_out, size_t& count) {
+    size_t i = begin;
+    for(; end - i >= 64 && count + 64 <= max_out; i += 64) {
+        emitBits(blockAVX2(data + i), i, out, count);
+    }
+    return end - i < 64 ? scanScalar(data, i, end, out, max_out, count) : i;
+}
+#endif
+
+/* The kernels by name, fastest first.  A kernel is usable when the CPU has
+ * what it needs.
+ */
+struct NamedKernel
+{
+    const char* name;
+    ScanKernel kernel;
+};
+
+static const NamedKernel KERNELS[] = {
+#ifdef TSV_X86
+    {"avx2", scanAVX2},
+    {"sse2", scanSSE2},
+#endif
+    {"scalar", scanScalar}
+};
+
+static bool cpuHas(string_view name) {
+#ifdef TSV_X86
+    __builtin_cpu_init();
+    if(name == "avx2") return __builtin_cpu_supports("avx2");
+    if(name == "sse2") return __builtin_cpu_supports("sse2");
+#endif
+    return name == "scalar";
+}
+
+static const NamedKernel& bestKernel() {
+    for(auto& k: KERNELS) {
+        if(cpuHas(k.name)) return k;
+    }
+    return KERNELS[sizeof(KERNELS) / sizeof(KERNELS[0]) - 1];
+}
+
+ScanKernel TsvScanner::kernel = bestKernel().kernel;
+const char* TsvScanner::kernel_name = bestKernel().name;
+
+// Returns whether the kernel called name exists and runs on this CPU.
+bool TsvScanner::supported(string_view name) {
+    for(auto& k: KERNELS) {
+        if(name == k.name) return cpuHas(name);
+    }
+    return false;
+}
+
+/* Makes every later scan use the kernel called name, for benchmarks and to
+ * check the kernels against each other.  Returns false and keeps the kernel
+ * if name is not supported.  Not to be called while something is scanning.
+ */
+bool TsvScanner::use(string_view name) {
+    for(auto& k: KERNELS) {
+        if(name == k.name && cpuHas(name)) {
+            kernel = k.kernel;
+            kernel_name = k.name;
+            return true;
+        }
+    }
+    return false;
+}
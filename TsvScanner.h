@@ -0,0 +1,120 @@
+/*
+ * File: TsvScanner.h
+ * Date: December 4, 2017
+ * Purpose: Declares the delimiter scanner every tab separated input goes
+ *      through: the cast file in both loaders and the lines of the pairs
+ *      files.  A kernel compares 64 bytes at a time against '\t' and '\n'
+ *      and writes the offsets of the matches, TsvReader then cuts rows and
+ *      fields at those offsets without looking at the bytes in between.
+ *      The kernel is picked once at startup from what the CPU supports:
+ *      avx2, sse2 or a plain byte loop on other machines.
+ */
+
+#ifndef TSVSCANNER_H
+#define TSVSCANNER_H
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+using namespace std;
+
+/* Writes the offsets from data of every '\t' and '\n' in data[begin, end) to
+ * out, stopping when out might overflow max_out.  count is the number of
+ * offsets in out and grows.  Returns the offset the scan stopped at.
+ */
+typedef size_t (*ScanKernel)(const char* data, size_t begin, size_t end, uint32_t* out,
+                             size_t max_out, size_t& count);
+
+class TsvScanner
+{
+    private:
+        static ScanKernel kernel;
+        static const char* kernel_name;
+
+    public:
+        static constexpr size_t MAX_SCAN = size_t(1) << 30; // bytes per call, offsets stay 32 bit
+
+        static ScanKernel current() { return kernel; }
+
+        static const char* currentName() { return kernel_name; }
+
+        static bool use(string_view name);
+
+        static bool supported(string_view name);
+};
+
+class TsvReader
+{
+    private:
+        static constexpr size_t BATCH = 1024; // delimiter offsets found per kernel call
+
+        string_view text;
+        size_t row_begin;  // first byte of the next row
+        size_t scanned;    // bytes of text the kernel has looked at
+        size_t base;       // delims are offsets from text[base]
+        size_t head;       // next unused entry of delims
+        size_t tail;       // entries of delims filled
+        uint32_t delims[BATCH];
+
+        // Returns the position of the next '\t' or '\n' in text, text.size()
+        // after the last one.
+        size_t nextDelimiter() {
+            while(head == tail) {
+                if(scanned == text.size()) return text.size();
+                base = scanned;
+                head = 0;
+                tail = 0;
+                size_t end = text.size() - base < TsvScanner::MAX_SCAN ?
+                             text.size() - base : TsvScanner::MAX_SCAN;
+                scanned = base + TsvScanner::current()(text.data() + base, 0, end, delims,
+                                                       BATCH, tail);
+            }
+            return base + delims[head++];
+        }
+
+    public:
+        TsvReader(string_view text) : text(text), row_begin(0), scanned(0), base(0), head(0), tail(0) {}
+
+        /* Cuts the next row into its tab separated fields following the same
+         * rules as repeated getline(ss, next, '\t'): an empty trailing field
+         * is dropped.  At most max_fields views are stored, count is the real
+         * field count so callers can still reject rows with too many
+         * columns.  Returns false after the last row.
+         */
+        bool nextRow(string_view* fields, size_t max_fields, size_t& count) {
+            if(row_begin >= text.size()) return false;
+
+            count = 0;
+            size_t field_begin = row_begin;
+            for(;;) {
+                size_t d = nextDelimiter();
+                if(d == text.size() || text[d] == '\n') {
+                    if(d > field_begin) {
+                        if(count < max_fields) fields[count] = text.substr(field_begin, d - field_begin);
+                        count++;
+                    }
+                    row_begin = d + 1;
+                    return true;
+                }
+                if(count < max_fields) fields[count] = text.substr(field_begin, d - field_begin);
+                count++;
+                field_begin = d + 1;
+            }
+        }
+
+        /* Splits one row into its tab separated fields by the rules of
+         * nextRow(), for lines the caller has already cut out.  Returns the
+         * real field count.
+         */
+        static size_t splitRecord(string_view line, string_view* fields, size_t max_fields) {
+            TsvReader reader(line);
+            size_t count = 0;
+            reader.nextRow(fields, max_fields, count);
+            return count;
+        }
+
+        // Returns the text after the rows read so far.
+        string_view rest() const {
+            return row_begin >= text.size() ? string_view() : text.substr(row_begin);
+        }
+};
+#endif
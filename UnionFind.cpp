@@ -0,0 +1,50 @@
+/* 
+ * File: UnionFind.cpp
+ * Date: December 4, 2017  
+ * Purpose: Implements the disjoint sets of actors.  Every merge records the
+ *      sentinel it put under another one, so reset() only undoes those
+ *      instead of visiting every actor.
+ */
+
+#include "UnionFind.h"
+
+using namespace std;
+
+// Makes every one of num_actors actors a set of its own.
+void UnionFind::resize(uint32_t num_actors) {
+    parent.resize(num_actors);
+    for(uint32_t x = 0; x < num_actors; x++) {
+        parent[x] = x;
+    }
+    sizes.assign(num_actors, 1);
+    touched.clear();
+}
+
+// Makes every actor a set of its own again.  A sentinel that grew still has
+// a recorded child pointing right at it, path halving never moves those.
+void UnionFind::reset() {
+    for(uint32_t x: touched) {
+        sizes[parent[x]] = 1;
+        sizes[x] = 1;
+        parent[x] = x;
+    }
+    touched.clear();
+}
+
+// Merges the sets of a and b, the smaller one goes under the larger one.
+// Returns false if they already were the same set.
+bool UnionFind::merge(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if(a == b) return false;
+
+    if(sizes[a] < sizes[b]) {
+        uint32_t tmp = a;
+        a = b;
+        b = tmp;
+    }
+    parent[b] = a;
+    sizes[a] += sizes[b];
+    touched.push_back(b);
+    return true;
+}
@@ -0,0 +1,43 @@
+/* 
+ * File: UnionFind.h
+ * Date: December 4, 2017  
+ * Purpose: Declares the disjoint sets of actors used by ufind.  The sets
+ *      live in flat arrays indexed by actor id, merge by size and find
+ *      halves the path it walks, so both are nearly O(1) amortized.
+ */
+
+#ifndef UNIONFIND_H
+#define UNIONFIND_H
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+class UnionFind
+{
+    private:
+        vector<uint32_t> parent;  // itself for a sentinel
+        vector<uint32_t> sizes;   // size of the set, only kept up to date in sentinels
+        vector<uint32_t> touched; // actors put under another one since reset()
+
+    public:
+        void resize(uint32_t num_actors);
+
+        void reset();
+
+        // Returns the sentinel of the set of x, pointing every other node on
+        // the way at its grandparent.
+        uint32_t find(uint32_t x) {
+            while(parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        }
+
+        bool merge(uint32_t a, uint32_t b);
+
+        uint32_t setSize(uint32_t x) { return sizes[find(x)]; }
+
+        uint32_t size() const { return parent.size(); }
+};
+#endif
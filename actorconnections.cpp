@@ -1,15 +1,29 @@
 /*
  *Overview of actorconnections.cpp: Given a movie database and a list of pair 
  *    actors, actorconnections will answer when every actor pair becomes 
- *    connected using either bfs or ufind algorithm.
+ *    connected using either bfs or ufind algorithm, or a prebuilt index.
  *    4 command arguments:
- *        (1) Name of a text faile containing the movie casts
+ *        (1) Name of a text faile containing the movie casts, - to read
+ *              them from the standard input
  *        (2) Name of text file containing the names of actor pairs 
  *        (3) Name of ouput text file
- *        (4) bfs or ufind (determines which algorithm to be used)  If fourth
- *              arguemnt is not given, default is ufind
+ *        (4) bfs, ufind or index (determines which algorithm to be used)  If
+ *              fourth arguemnt is not given, default is ufind.  index builds
+ *              (or loads with --load-snapshot) a ConnectionIndex once and
+ *              looks every pair up in O(log n)
+ *    options:
+ *        --threads N  number of threads used to load the movie casts
+ *        --bipartite  let bfs search the actor <-> movie incidence lists
+ *                     instead of building a co-star clique for every movie
+ *        --save-snapshot FILE  write the loaded (ufind) or built (bfs, index)
+ *                     graph to a binary snapshot
+ *        --load-snapshot FILE  use a snapshot instead of reading (1), bfs
+ *                     needs one saved by bfs with the same --bipartite
+ *        --offline    let ufind read every pair first and answer them all in
+ *                     a single sweep over the years
  */ 
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <queue>
@@ -22,28 +36,51 @@
 #include "util.cpp"
 using namespace std;
 
-bool BFS(ActorNode* start, ActorNode* end);  //declaration of BFS method
+/** a pair of actors answered by the offline sweep **/
+struct PendingPair
+{
+    string actor1;
+    string actor2;
+    uint32_t start;
+    uint32_t end;
+    int year; // year the two become connected, 9999 if never
+};
+
+template<class Graph>
+int BFS(const Graph& graph, SearchWorkspace& ws, vector<vector<uint32_t>>& later,
+        const vector<int>& years, uint32_t start, uint32_t end);  //declaration of BFS method
 
 int main(int argc, char* argv[]) {
-    ifstream in1(argv[1]);
-    ifstream in2(argv[2]);
-    ifstream in3(argv[3]);
+    unsigned num_threads = Utils::takeThreads(argc, argv);
+    bool use_bipartite = Utils::takeFlag(argc, argv, "--bipartite");
+    const char* save_snapshot = Utils::takeOption(argc, argv, "--save-snapshot");
+    const char* load_snapshot = Utils::takeOption(argc, argv, "--load-snapshot");
+    bool offline = Utils::takeFlag(argc, argv, "--offline");
 
     /** Null checks **/
     // check number of args
     if(argc < 4 || argc > 5) {
         cerr << "Invalid amount of arguments" << endl;
         cerr << "Example: ./actorconnections movie_casts.tsv test_paris.tsv" 
-             <<  "out_connections_bfs.tsv ufind" << endl;
+             <<  "out_connections_bfs.tsv ufind [--threads N] [--bipartite]"
+             << " [--save-snapshot FILE] [--load-snapshot FILE] [--offline]" << endl;
+        return -1;
+    }
+    if(offline && argc == 5 && string(argv[4]) != "ufind") {
+        cerr << "--offline only works with ufind" << endl;
         return -1;
     }
 
+    bool from_stdin = string(argv[1]) == "-"; // read the casts from a pipe
+    ifstream in1(argv[1]);
+    ifstream in2(argv[2]);
+
     // check if argv[1] is valid
-    if(!in1.good()) {
+    if(load_snapshot == nullptr && !from_stdin && !in1.good()) {
         cerr << "argv[1]File does not exist" << endl;
         return -1;
     }
-    if(in1.peek() == ifstream::traits_type::eof()) {
+    if(load_snapshot == nullptr && !from_stdin && in1.peek() == ifstream::traits_type::eof()) {
         cout << "argv[1] File is empty" << endl;
         return -1;
     }
@@ -60,7 +97,16 @@ int main(int argc, char* argv[]) {
 
     // Initialize actor graph 
     ActorGraph* actor_graph = new ActorGraph(); 
-    actor_graph->loadFromFile(argv[1], false); // build empty graph of actor nodes
+    actor_graph->setThreads(num_threads);
+    if(load_snapshot != nullptr) {
+        if(!actor_graph->loadSnapshot(load_snapshot)) return -1;
+    }
+    else {
+        // build empty graph of actor nodes, streamed from a pipe with -
+        bool loaded = from_stdin ? actor_graph->loadFromFile(argv[1], false) :
+                                   actor_graph->loadFromMappedFile(argv[1], false);
+        if(!loaded) return -1;
+    }
     actor_graph->sortMovies(); // sort the movies by year into a queue
 
     // Open outfile for writing
@@ -74,11 +120,37 @@ int main(int argc, char* argv[]) {
     bool have_header = false;
 
     /** Implement BFS **/
-    if(argv[4] == "bfs"){
+    if(argc == 5 && string(argv[4]) == "bfs"){
         //timer.begin_timer();  <- used for comparing computational times
 
-        ActorNode* start;
-        ActorNode* end;
+        uint32_t start;
+        uint32_t end;
+
+        // build the whole graph once, every edge labelled with the earliest
+        // year its two actors shared a movie
+        if(load_snapshot != nullptr) {
+            bool has_layout = use_bipartite ? actor_graph->hasBipartite() : actor_graph->hasClique();
+            if(actor_graph->weightMode() != YEAR_WEIGHTS || !has_layout) {
+                cerr << load_snapshot << " was not saved by bfs with this --bipartite setting" << endl;
+                return -1;
+            }
+        }
+        else {
+            actor_graph->useYears();
+            if(use_bipartite) {
+                actor_graph->buildBipartite();
+            }
+            else {
+                actor_graph->build();
+            }
+        }
+        if(save_snapshot != nullptr) {
+            if(!actor_graph->saveSnapshot(save_snapshot)) return -1;
+        }
+        vector<int> years = actor_graph->movieYears();
+        SearchWorkspace ws;
+        actor_graph->initWorkspace(ws);
+        vector<vector<uint32_t>> later(years.size()); // actors waiting for a later year
 
         while(in2) { // find the year each pair of actors become connected
             string line;
@@ -91,48 +163,119 @@ int main(int argc, char* argv[]) {
                 continue;
             }
 
-		    istringstream ss(line);
-		    vector<string> record;
+            // get the names of the starting and ending vertices
+            string_view record[2];
+            size_t fields = TsvReader::splitRecord(line, record, 2);
 
-		    // get the names of the starting and ending vertices
-		    while(ss) {
-			    string next;
-			    if(!getline(ss, next, '\t')) break;
+            start = fields < 1 ? NO_ID : actor_graph->getActor(record[0]); // the starting actor
+            end = fields < 2 ? NO_ID : actor_graph->getActor(record[1]); // the ending actor
 
-		  	    record.push_back(next);
-		    }
+            if(start == NO_ID || end == NO_ID) {
+                cerr << "Unknown actor in pair: " << line << endl;
+                continue;
+            }
 
-            actor_graph->resetNeighbors(); // revert to empty graph of actor nodes
-	        actor_graph->sortMovies(); // reinitialize queue of sorted movies
+            // grow the search from start one year at a time
+            ws.reset();
+            int year = use_bipartite ?
+                    BFS(actor_graph->incidence(), ws, later, years, start, end) :
+                    BFS(actor_graph->adjacency(), ws, later, years, start, end);
 
-            start = actor_graph->getActor(record[0]); // the starting ActorNode
-		    end = actor_graph->getActor(record[1]); // the ending ActorNode
+            // prints 9999 if no path exists after all years were added
+            outfile << record[0] << "\t" << record[1] << "\t" << year << endl;
+        }
+        //long bfsruntime = timer.end_timer();
+        //cout << "BFS runtime: " << bfsruntime << endl;
+    }
+    /** looks every pair up in the connection year index **/
+    else if(argc == 5 && string(argv[4]) == "index") {
+        if(!actor_graph->connectionIndex().built()) {
+            actor_graph->buildConnections();
+        }
+        if(save_snapshot != nullptr) {
+            if(!actor_graph->saveSnapshot(save_snapshot)) return -1;
+        }
+        const ConnectionIndex& index = actor_graph->connectionIndex();
+
+        string line;
+        getline(in2, line); // skip the header
+        while(getline(in2, line)) {
+            string_view record[2];
+            size_t fields = TsvReader::splitRecord(line, record, 2);
+
+            uint32_t start = fields < 1 ? NO_ID : actor_graph->getActor(record[0]); // the starting actor
+            uint32_t end = fields < 2 ? NO_ID : actor_graph->getActor(record[1]); // the ending actor
+            if(start == NO_ID || end == NO_ID) {
+                cerr << "Unknown actor in pair: " << line << endl;
+                continue;
+            }
 
-            // create the graph by year
-            bool path_exists = false;
-            while(actor_graph->buildByYear()) { 
-                actor_graph->resetNodes();
-                if(BFS(start, end)) { // if BFS returns true, path exists
-                    path_exists = true;
-                    outfile << start->name << "\t" << end->name <<
-                            "\t" << actor_graph->curr_year << endl;
-                    break;
-                }
+            // prints 9999 if no path exists between actors
+            outfile << record[0] << "\t" << record[1] << "\t" << index.connectedYear(start, end) << "\n";
+        }
+    }
+    /** implements ufind with a single sweep over the years for all pairs **/
+    else if(offline) {
+        if(save_snapshot != nullptr) {
+            if(!actor_graph->saveSnapshot(save_snapshot)) return -1;
+        }
+
+        // read every pair first
+        vector<PendingPair> pairs;
+        string line;
+        getline(in2, line); // skip the header
+        while(getline(in2, line)) {
+            string_view record[2];
+            size_t fields = TsvReader::splitRecord(line, record, 2);
+
+            PendingPair p;
+            p.start = fields < 1 ? NO_ID : actor_graph->getActor(record[0]); // the starting actor
+            p.end = fields < 2 ? NO_ID : actor_graph->getActor(record[1]); // the ending actor
+            if(p.start == NO_ID || p.end == NO_ID) {
+                cerr << "Unknown actor in pair: " << line << endl;
+                continue;
             }
+            p.actor1 = string(record[0]);
+            p.actor2 = string(record[1]);
+            p.year = 9999;
+            pairs.push_back(p);
+        }
+
+        vector<size_t> pending(pairs.size()); // pairs not connected yet
+        for(size_t i = 0; i < pairs.size(); i++) {
+            pending[i] = i;
+        }
 
-            if(!path_exists) { // if no path exists after all years were added
-                outfile << start->name << "\t" << end->name << "\t" << "9999" << endl;
+        // add the movies year by year into one union-find, after every year
+        // the pairs that became connected get that year
+        actor_graph->resetNodes();
+        actor_graph->sortMovies();
+        while(!pending.empty() && actor_graph->ufindByYear()) {
+            size_t still_pending = 0;
+            for(size_t i: pending) {
+                if(actor_graph->findSet(pairs[i].start) == actor_graph->findSet(pairs[i].end)) {
+                    pairs[i].year = actor_graph->curr_year;
+                }
+                else {
+                    pending[still_pending++] = i;
+                }
             }
+            pending.resize(still_pending);
+        }
+
+        for(auto& p: pairs) { // prints 9999 if no path exists between actors
+            outfile << p.actor1 << "\t" << p.actor2 << "\t" << p.year << "\n";
         }
-        //long bfsruntime = timer.end_timer();
-        //cout << "BFS runtime: " << bfsruntime << endl;
     }
         /** implements ufind (default if no algorithm is given) **/
     else {
         //timer.begin_timer();
+        if(save_snapshot != nullptr) {
+            if(!actor_graph->saveSnapshot(save_snapshot)) return -1;
+        }
 
-        ActorNode* start;
-        ActorNode* end;
+        uint32_t start;
+        uint32_t end;
 
         while(in2) { // find the year each pair of actors become connected
             string line;
@@ -144,47 +287,34 @@ int main(int argc, char* argv[]) {
                 continue;
             }
 
-		    istringstream ss(line);
-		    vector<string> record;
+            // get the names of the starting and ending vertices
+            string_view record[2];
+            size_t fields = TsvReader::splitRecord(line, record, 2);
 
-		    // get the names of the starting and ending vertices
-		    while(ss) {
-			    string next;
-			    if(!getline(ss, next, '\t')) break;
+            start = fields < 1 ? NO_ID : actor_graph->getActor(record[0]); // the starting actor
+            end = fields < 2 ? NO_ID : actor_graph->getActor(record[1]); // the ending actor
 
-		  	    record.push_back(next);
+            if(start == NO_ID || end == NO_ID) {
+                cerr << "Unknown actor in pair: " << line << endl;
+                continue;
             }
-           
+
             actor_graph->resetNodes(); // revert to empty graph of actor nodes
             actor_graph->sortMovies(); // reinitialize queue of sorted movies
-            
-            start = actor_graph->getActor(record[0]); // the starting ActorNode
-            end = actor_graph->getActor(record[1]); // the ending ActorNode
-            
-            ActorNode* start_parent = start;
-            ActorNode* end_parent = end;
 
             bool path_exists = false;
             // create graph by year
             while(actor_graph->ufindByYear()) {
-                while(start_parent->parent != nullptr) { // traverse up tree
-                    start_parent = start_parent->parent;
-                 }
-
-                 while(end_parent->parent != nullptr) { // traverse up tree
-                     end_parent = end_parent->parent;
-                 }
-
-                 if(start_parent == end_parent) { // we then know a path exits
+                 if(actor_graph->findSet(start) == actor_graph->findSet(end)) { // we then know a path exits
                     path_exists = true;
-                    outfile << start->name << "\t" << end->name <<
+                    outfile << record[0] << "\t" << record[1] <<
                             "\t" << actor_graph->curr_year << endl;
 
                     break;
                  }
             }
             if(!path_exists) {  // prints 9999 if no path exists between actors
-                outfile << start->name << "\t" << end->name << "\t" << "9999" << endl;
+                outfile << record[0] << "\t" << record[1] << "\t" << "9999" << endl;
             }
         }
         //long ufindRuntime = timer.end_timer();
@@ -202,39 +332,58 @@ int main(int argc, char* argv[]) {
 }
 
 /**Function to implement the BFS algorithm
- * Purpose: Uses BFS algorithm to find the connection between actors 
- * Inputs: Two actor nodes 
- * Outputs: True if path exists, false if not **/
-bool BFS(ActorNode* start, ActorNode* end) {
-    queue<ActorNode*> q; //initialize queue
-    start->dist = 0; //set the distance to 0
+ * Purpose: Uses BFS algorithm to find the year two actors become connected.
+ *      The actors reached from start are kept from one year to the next: an
+ *      edge whose movie came out after the current year is put aside under
+ *      that year, and the search only continues from those edges once their
+ *      year comes.  Every edge of the component of start is looked at a
+ *      constant number of times, however many years it takes.
+ * Inputs: The adjacency to search (clique or bipartite), a workspace reset
+ *      for this search, one list per year to put edges aside in, the sorted
+ *      years of the movies and the ids of two actors
+ * Outputs: The year the actors become connected, 9999 if they never do **/
+template<class Graph>
+int BFS(const Graph& graph, SearchWorkspace& ws, vector<vector<uint32_t>>& later,
+        const vector<int>& years, uint32_t start, uint32_t end) {
+    for(auto& actors: later) {
+        actors.clear();
+    }
+
+    queue<uint32_t> q; //initialize queue
+    ws.setDone(start); // done marks the actors reached so far
     q.push(start); //add to queue
 
-    ActorNode* curr;
-
-    while(!q.empty()) { // conduct BFS on graph created up to current year
-        curr = q.front();
-        q.pop();
-        if(!curr->done) {
-            curr->done = true;
-            for(unsigned int i = 0; i < curr->neighborSize(); i++) {
-                if(curr->neighbors[i]->dist > curr->dist + 1) {
-                    curr->neighbors[i]->dist = curr->dist + 1;
-                    curr->neighbors[i]->prev = curr;
-                    q.push(curr->neighbors[i]);
-                }
-            }
+    for(size_t y = 0; y < years.size(); y++) { // add the movies of each year
+        int year = years[y];
+
+        // the edges put aside for this year reach past the old actors
+        for(uint32_t next: later[y]) {
+            if(ws.done(next)) continue;
+            if(next == end) return year;
+
+            ws.setDone(next);
+            q.push(next);
         }
-    }
 
-    // check if path exists between actors in this year
-    curr = end;
-    while(curr->prev != nullptr) { //traverse through curr->prev
-        curr = curr->prev;
-        if(curr == start) { // path exists
-            return true;
+        while(!q.empty()) { // conduct BFS on graph created up to current year
+            uint32_t curr = q.front();
+            q.pop();
+            graph.forEachEdge(curr, ws, [&](uint32_t next, int weight, uint32_t) {
+                if(ws.done(next)) return;
+
+                if(weight > year) { // movies released after year wait for theirs
+                    size_t slot = lower_bound(years.begin(), years.end(), weight) - years.begin();
+                    later[slot].push_back(next);
+                    return;
+                }
+                ws.setDone(next);
+                q.push(next);
+            });
 
+            if(ws.done(end) && end != start) { // path exists
+                return year;
+            }
         }
     }
-    return false;
+    return 9999;
 }
@@ -0,0 +1,837 @@
+/*
+ * Date: December 4, 2017
+ * File: graphbench.cpp
+ *     Purpose: Benchmarks of the graph code on a movie cast file.
+ *     -> 2 command arguments :
+ *      (1) Name of the benchmark to run
+ *      (2) Name of text file containing the movie casts
+ *     -> benchmarks :
+ *      queue   weighted shortest paths between random actor pairs on the
+ *              binary heap and on the bucket queue
+ *      ufind   adding every movie to the ufind sets and asking whether
+ *              random actor pairs are connected, UnionFind against the
+ *              original parent pointers that merged every pair of a cast
+ *      connect the year random actor pairs got connected, looked up in the
+ *              ConnectionIndex against one ufind sweep over the years
+ *      alt     weighted shortest paths between random actor pairs with
+ *              dijkstra on the heap and with A* aimed by landmarks, after
+ *              timing the landmark selection
+ *      bfs     whole-graph breadth first searches from the first actor of
+ *              every pair, a queue against FrontierBFS on --threads
+ *              threads.  Checks the distances and the parent trees
+ *      cache   cache misses and references of dijkstra per settled actor,
+ *              read from the hardware counters with perf_event_open
+ *      order   dijkstra and the bidirectional BFS on the same pairs with
+ *              the actors in natural, bfs, degree and rcm order, see
+ *              NodeOrder.h.  Checks the paths stay the same
+ *      compress bytes per edge of the clique as CsrGraph and as
+ *              CompressedGraph, in natural and in bfs order, and the time
+ *              of a scan over every edge, dijkstra and the bidirectional
+ *              BFS on both.  Checks both find the same paths
+ *      parse   delimiter scanning of the cast file with every kernel the
+ *              CPU supports, then loadFromFile against loadFromMappedFile
+ *              and the busy and waiting time of every stage of the
+ *              stream loader.  Checks all of them find the same rows
+ *     -> options :
+ *      --pairs N    number of random actor pairs (default 1000)
+ *      --landmarks K  number of landmarks of alt (default 16)
+ *      --seed N     seed of the random pairs (default 1)
+ *      --threads N  number of threads used to load the movie casts
+ *      --bipartite  search the incidence lists instead of the clique
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "ActorNode.h"
+#include "Movie.h"
+#include "ActorGraph.h"
+#include "ActorGraph.cpp"
+#include "FrontierBFS.h"
+#include "FrontierBFS.cpp"
+#include "PathSearch.h"
+#include "util.h"
+#include "util.cpp"
+using namespace std;
+
+/** settings shared by every benchmark **/
+struct BenchOptions
+{
+    size_t num_pairs;
+    unsigned seed;
+    uint32_t num_landmarks;
+    bool use_bipartite;
+};
+
+/**Function to draw the actor pairs of a benchmark
+ * Purpose: Returns num_pairs pairs of actor ids, the same ones for the same
+ *      graph and seed **/
+vector<pair<uint32_t, uint32_t>> randomPairs(const ActorGraph& graph, const BenchOptions& opts) {
+    mt19937 rng(opts.seed);
+    uniform_int_distribution<uint32_t> actor(0, graph.numActors() - 1);
+
+    vector<pair<uint32_t, uint32_t>> pairs;
+    for(size_t i = 0; i < opts.num_pairs; i++) {
+        uint32_t start = actor(rng);
+        pairs.push_back(make_pair(start, actor(rng)));
+    }
+    return pairs;
+}
+
+/** the sets ufind used before UnionFind: parent pointers without path
+ *  compression and a merge for every pair of actors of a movie **/
+class PairwiseSets
+{
+    private:
+        vector<uint32_t> parent;
+        vector<int> size;
+
+    public:
+        PairwiseSets(uint32_t num_actors) : parent(num_actors, NO_ID), size(num_actors, 1) {}
+
+        uint32_t find(uint32_t node) {
+            while(parent[node] != NO_ID) { //traverse up
+                node = parent[node];
+            }
+            return node;
+        }
+
+        void merge(uint32_t n1, uint32_t n2) {
+            uint32_t sent1 = find(n1);
+            uint32_t sent2 = find(n2);
+            if(sent1 == sent2) return;
+
+            if(size[sent1] > size[sent2]) { //merge to the larger tree
+                parent[sent2] = sent1;
+                size[sent1] += size[sent2];
+            }
+            else {
+                parent[sent1] = sent2;
+                size[sent2] += size[sent1];
+            }
+        }
+
+};
+
+// Adds a movie to the old sets, a merge for every pair of its cast.
+void addMovie(PairwiseSets& sets, const Movie& movie) {
+    const FlatArray<uint32_t>& cast = movie.getCast();
+    for(size_t i = 0; i + 1 < cast.size(); i++) {
+        for(size_t j = i + 1; j < cast.size(); j++) {
+            sets.merge(cast[i], cast[j]);
+        }
+    }
+}
+
+// Adds a movie to UnionFind the way ufindByYear() does.
+void addMovie(UnionFind& sets, const Movie& movie) {
+    movie.ufind(sets);
+}
+
+/**Function to time one union-find
+ * Purpose: Adds the movies in order, then asks whether every pair is
+ *      connected.  Returns the nanoseconds of both steps and the number of
+ *      connected pairs **/
+template<class Sets>
+size_t timeSets(const ActorGraph& actor_graph, Sets& sets, const vector<uint32_t>& order,
+                const vector<pair<uint32_t, uint32_t>>& pairs, long long& add_ns, long long& find_ns) {
+    Timer timer;
+
+    timer.begin_timer();
+    for(uint32_t m: order) {
+        addMovie(sets, actor_graph.getMovie(m));
+    }
+    add_ns = timer.end_timer();
+
+    size_t connected = 0;
+    timer.begin_timer();
+    for(auto& p: pairs) {
+        connected += sets.find(p.first) == sets.find(p.second);
+    }
+    find_ns = timer.end_timer();
+    return connected;
+}
+
+/**Function to compare the union-finds of ufind
+ * Purpose: Adds every movie in order of year to both and times it and the
+ *      same random connectivity questions **/
+int benchUfind(const ActorGraph& actor_graph, const BenchOptions& opts) {
+    vector<uint32_t> order(actor_graph.numMovies());
+    for(uint32_t m = 0; m < order.size(); m++) {
+        order[m] = m;
+    }
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return actor_graph.getMovie(a).year < actor_graph.getMovie(b).year;
+    });
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+
+    long long old_add_ns, old_find_ns, new_add_ns, new_find_ns;
+    PairwiseSets old_sets(actor_graph.numActors());
+    size_t old_connected = timeSets(actor_graph, old_sets, order, pairs, old_add_ns, old_find_ns);
+
+    UnionFind new_sets;
+    new_sets.resize(actor_graph.numActors());
+    size_t new_connected = timeSets(actor_graph, new_sets, order, pairs, new_add_ns, new_find_ns);
+
+    cout << "sets\tadd_ms\tfind_ms\tconnected_pairs" << endl;
+    cout << "pairwise\t" << old_add_ns / 1000000 << "\t" << old_find_ns / 1000000
+         << "\t" << old_connected << endl;
+    cout << "unionfind\t" << new_add_ns / 1000000 << "\t" << new_find_ns / 1000000
+         << "\t" << new_connected << endl;
+    cout << "speedup\t" << (double) old_add_ns / new_add_ns << "\t"
+         << (double) old_find_ns / new_find_ns << endl;
+
+    if(old_connected != new_connected) {
+        cerr << "The union-finds disagree" << endl;
+        return -1;
+    }
+    return 0;
+}
+
+/**Function to compare the connection index with a ufind sweep
+ * Purpose: Times building the index and looking up every pair, and the
+ *      single sweep over the years that answers the same pairs **/
+int benchConnect(ActorGraph& actor_graph, const BenchOptions& opts) {
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+    Timer timer;
+
+    timer.begin_timer();
+    actor_graph.buildConnections();
+    long long build_ns = timer.end_timer();
+
+    vector<int> index_years(pairs.size());
+    const ConnectionIndex& index = actor_graph.connectionIndex();
+    timer.begin_timer();
+    for(size_t i = 0; i < pairs.size(); i++) {
+        index_years[i] = index.connectedYear(pairs[i].first, pairs[i].second);
+    }
+    long long query_ns = timer.end_timer();
+
+    // the sweep adds a year of movies at a time and resolves the pairs that
+    // became connected, like actorconnections --offline
+    vector<int> sweep_years(pairs.size(), ConnectionIndex::NEVER);
+    vector<size_t> pending(pairs.size());
+    for(size_t i = 0; i < pending.size(); i++) {
+        pending[i] = i;
+    }
+    timer.begin_timer();
+    actor_graph.resetNodes();
+    actor_graph.sortMovies();
+    while(!pending.empty() && actor_graph.ufindByYear()) {
+        size_t kept = 0;
+        for(size_t i: pending) {
+            if(actor_graph.findSet(pairs[i].first) == actor_graph.findSet(pairs[i].second)) {
+                sweep_years[i] = actor_graph.curr_year;
+            }
+            else {
+                pending[kept++] = i;
+            }
+        }
+        pending.resize(kept);
+    }
+    long long sweep_ns = timer.end_timer();
+
+    cout << "method\tpairs\tbuild_ms\tquery_ms\tns_per_pair" << endl;
+    cout << "index\t" << pairs.size() << "\t" << build_ns / 1000000 << "\t"
+         << query_ns / 1000000 << "\t" << query_ns / pairs.size() << endl;
+    cout << "sweep\t" << pairs.size() << "\t0\t" << sweep_ns / 1000000 << "\t"
+         << sweep_ns / pairs.size() << endl;
+
+    if(index_years != sweep_years) {
+        cerr << "The index and the sweep disagree" << endl;
+        return -1;
+    }
+    return 0;
+}
+
+/**Function to run a plain breadth first search
+ * Purpose: Fills dist with the number of edges from source to every actor,
+ *      INT_MAX for the actors it does not reach **/
+void queueBFS(const CsrGraph& graph, uint32_t source, vector<int>& dist, vector<uint32_t>& q) {
+    dist.assign(graph.numNodes(), INT_MAX);
+    q.clear();
+    dist[source] = 0;
+    q.push_back(source);
+    for(size_t head = 0; head < q.size(); head++) {
+        uint32_t curr = q[head];
+        for(uint64_t i = graph.begin(curr); i < graph.end(curr); i++) {
+            uint32_t next = graph.targets[i];
+            if(dist[next] == INT_MAX) {
+                dist[next] = dist[curr] + 1;
+                q.push_back(next);
+            }
+        }
+    }
+}
+
+// Returns true if every reached actor but source has a neighbor one edge
+// closer to source as its parent.
+bool validTree(const CsrGraph& graph, const FrontierBFS& bfs, uint32_t source) {
+    for(uint32_t v = 0; v < graph.numNodes(); v++) {
+        uint32_t p = bfs.parent(v);
+        if(v == source || bfs.dist[v] == INT_MAX) {
+            if(p != (v == source ? source : NO_ID)) return false;
+            continue;
+        }
+        if(p == NO_ID || bfs.dist[p] != bfs.dist[v] - 1 ||
+           graph.findEdge(p, v) == graph.numEdges()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**Function to compare the serial and the parallel breadth first search
+ * Purpose: Searches the whole graph from every source with both, prints
+ *      their times and how far the sources reach, and checks that the
+ *      distances agree and the parent trees are shortest path trees **/
+int benchBFS(ActorGraph& actor_graph, const BenchOptions& opts) {
+    const CsrGraph& graph = actor_graph.adjacency();
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+    Timer timer;
+
+    vector<int> dist;
+    vector<uint32_t> q;
+    long long queue_ns = 0;
+    long long frontier_ns = 0;
+    uint64_t reached = 0;
+    int depth = 0;
+    unsigned top_down = 0;
+    unsigned bottom_up = 0;
+    FrontierBFS bfs;
+
+    for(auto& p: pairs) {
+        timer.begin_timer();
+        queueBFS(graph, p.first, dist, q);
+        queue_ns += timer.end_timer();
+
+        timer.begin_timer();
+        reached += bfs.search(graph, actor_graph.threads(), p.first);
+        frontier_ns += timer.end_timer();
+        top_down += bfs.top_down_steps;
+        bottom_up += bfs.bottom_up_steps;
+
+        if(bfs.dist != dist || !validTree(graph, bfs, p.first)) {
+            cerr << "The searches from " << actor_graph.actorName(p.first) << " disagree" << endl;
+            return -1;
+        }
+        for(uint32_t v: q) {
+            depth = max(depth, dist[v]);
+        }
+    }
+
+    cout << "search\tsources\tms\tms_per_source" << endl;
+    cout << "queue\t" << pairs.size() << "\t" << queue_ns / 1000000 << "\t"
+         << (double) queue_ns / 1000000 / pairs.size() << endl;
+    cout << "frontier\t" << pairs.size() << "\t" << frontier_ns / 1000000 << "\t"
+         << (double) frontier_ns / 1000000 / pairs.size() << endl;
+    cout << "speedup\t" << (double) queue_ns / frontier_ns << "\t" << actor_graph.numThreads()
+         << " threads" << endl;
+    cout << "reached " << (double) reached / pairs.size() << " actors per source, depth "
+         << depth << ", steps " << top_down << " top-down " << bottom_up << " bottom-up" << endl;
+    return 0;
+}
+
+/**Function to time one search engine
+ * Purpose: Finds the shortest path of every pair and returns the time it
+ *      took in nanoseconds.  checksum sums the lengths, actor ranks and
+ *      movies of every path, so engines that find the same paths get the same
+ *      checksum, in any order of the actors **/
+template<class Graph>
+long long timePaths(const Graph& graph, PathWorker& worker, SearchEngine engine,
+                    const vector<pair<uint32_t, uint32_t>>& pairs, uint64_t& checksum) {
+    Timer timer;
+    checksum = 0;
+
+    timer.begin_timer();
+    for(auto& p: pairs) {
+        findShortestPath(graph, worker, engine, p.first, p.second);
+
+        int dist = worker.ws.dist(p.second);
+        if(dist == INT_MAX) continue;
+
+        checksum += dist;
+        for(uint32_t curr = p.second; curr != p.first; curr = worker.ws.prev(curr)) {
+            checksum = (checksum * 31 + worker.ws.rank(curr)) * 31 + worker.ws.prevMovie(curr);
+        }
+    }
+    return timer.end_timer();
+}
+
+/**Function to compare the priority queues of dijkstra
+ * Purpose: Runs the same random pairs on the heap and the bucket queue and
+ *      prints the time of both **/
+template<class Graph>
+int benchQueue(ActorGraph& actor_graph, const Graph& graph, const BenchOptions& opts) {
+    if(actor_graph.minWeight() < 1) {
+        cerr << "The bucket queue needs weights of at least 1" << endl;
+        return -1;
+    }
+
+    PathWorker worker;
+    actor_graph.initWorkspace(worker.ws);
+    worker.buckets.init(actor_graph.maxWeight());
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+
+    uint64_t heap_sum;
+    uint64_t bucket_sum;
+    long long heap_ns = timePaths(graph, worker, HEAP_DIJKSTRA, pairs, heap_sum);
+    long long bucket_ns = timePaths(graph, worker, BUCKET_DIJKSTRA, pairs, bucket_sum);
+
+    cout << "queue\tpairs\tms\tus_per_pair\tchecksum" << endl;
+    cout << "heap\t" << pairs.size() << "\t" << heap_ns / 1000000 << "\t"
+         << heap_ns / 1000 / pairs.size() << "\t" << heap_sum << endl;
+    cout << "bucket\t" << pairs.size() << "\t" << bucket_ns / 1000000 << "\t"
+         << bucket_ns / 1000 / pairs.size() << "\t" << bucket_sum << endl;
+    cout << "speedup\t" << (double) heap_ns / bucket_ns << endl;
+
+    if(heap_sum != bucket_sum) {
+        cerr << "The queues found different paths" << endl;
+        return -1;
+    }
+    return 0;
+}
+
+/**Function to compare dijkstra with A* on landmarks
+ * Purpose: Picks the landmarks, then runs the same random pairs with both
+ *      and prints the time of each.  The paths have to be the same **/
+template<class Graph>
+int benchAlt(ActorGraph& actor_graph, const Graph& graph, const BenchOptions& opts) {
+    if(actor_graph.minWeight() < 1 || opts.num_landmarks < 1) {
+        cerr << "A* needs weights of at least 1 and a landmark" << endl;
+        return -1;
+    }
+
+    Timer timer;
+    timer.begin_timer();
+    actor_graph.buildLandmarks(opts.num_landmarks);
+    long long select_ns = timer.end_timer();
+
+    PathWorker worker;
+    actor_graph.initWorkspace(worker.ws);
+    worker.landmarks = &actor_graph.landmarkTable();
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+
+    uint64_t dijkstra_sum;
+    uint64_t astar_sum;
+    long long dijkstra_ns = timePaths(graph, worker, HEAP_DIJKSTRA, pairs, dijkstra_sum);
+    long long astar_ns = timePaths(graph, worker, ALT_ASTAR, pairs, astar_sum);
+
+    cout << actor_graph.landmarkTable().numLandmarks() << " landmarks picked in "
+         << select_ns / 1000000 << " ms" << endl;
+    cout << "search\tpairs\tms\tus_per_pair\tchecksum" << endl;
+    cout << "dijkstra\t" << pairs.size() << "\t" << dijkstra_ns / 1000000 << "\t"
+         << dijkstra_ns / 1000 / pairs.size() << "\t" << dijkstra_sum << endl;
+    cout << "alt\t" << pairs.size() << "\t" << astar_ns / 1000000 << "\t"
+         << astar_ns / 1000 / pairs.size() << "\t" << astar_sum << endl;
+    cout << "speedup\t" << (double) dijkstra_ns / astar_ns << endl;
+
+    if(dijkstra_sum != astar_sum) {
+        cerr << "A* found different paths" << endl;
+        return -1;
+    }
+    return 0;
+}
+
+/** hardware event counter of the calling thread, read through
+ *  perf_event_open.  Virtual machines often have no such counters, then
+ *  available() is false and every count is 0 **/
+class PerfCounter
+{
+    private:
+        int fd;
+
+    public:
+        PerfCounter(uint64_t event) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = event;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+
+        ~PerfCounter() { if(fd >= 0) close(fd); }
+
+        bool available() const { return fd >= 0; }
+
+        void start() { if(fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); }
+
+        void stop() { if(fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); }
+
+        uint64_t count() const {
+            uint64_t value = 0;
+            if(fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+            return value;
+        }
+};
+
+/**Function to measure the memory traffic of the search state
+ * Purpose: Runs dijkstra on the heap for every pair with the cache miss and
+ *      cache reference counters on and prints both per settled actor, along
+ *      with the time per settled actor **/
+template<class Graph>
+int benchCache(ActorGraph& actor_graph, const Graph& graph, const BenchOptions& opts) {
+    PathWorker worker;
+    actor_graph.initWorkspace(worker.ws);
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+
+    PerfCounter misses(PERF_COUNT_HW_CACHE_MISSES);
+    PerfCounter references(PERF_COUNT_HW_CACHE_REFERENCES);
+    if(!misses.available() || !references.available()) {
+        cerr << "No hardware cache counters here, only the time is measured" << endl;
+    }
+
+    Timer timer;
+    long long search_ns = 0;
+    uint64_t settled = 0;
+    for(auto& p: pairs) {
+        timer.begin_timer();
+        misses.start();
+        references.start();
+        findShortestPath(graph, worker, HEAP_DIJKSTRA, p.first, p.second);
+        references.stop();
+        misses.stop();
+        search_ns += timer.end_timer();
+
+        for(uint32_t a = 0; a < actor_graph.numActors(); a++) {
+            settled += worker.ws.done(a);
+        }
+    }
+    if(settled == 0) settled = 1;
+
+    cout << "pairs\tsettled\tns_per_settled\tmisses_per_settled\treferences_per_settled" << endl;
+    cout << pairs.size() << "\t" << settled << "\t" << (double) search_ns / settled << "\t";
+    if(misses.available() && references.available()) {
+        cout << (double) misses.count() / settled << "\t"
+             << (double) references.count() / settled << endl;
+    }
+    else {
+        cout << "n/a\tn/a" << endl;
+    }
+    return 0;
+}
+
+/**Function to compare the orders the actors can be numbered in
+ * Purpose: Renumbers the graph into every order in turn and runs the same
+ *      pairs, drawn before any renumbering, with dijkstra on the heap and
+ *      with the bidirectional BFS.  The paths, not just their lengths, have
+ *      to be the same in every order **/
+int benchOrder(ActorGraph& actor_graph, const BenchOptions& opts) {
+    const NodeOrdering orderings[] = {NATURAL_ORDER, BFS_ORDER, DEGREE_ORDER, RCM_ORDER};
+    const char* names[] = {"natural", "bfs", "degree", "rcm"};
+
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+    vector<uint32_t> original(actor_graph.numActors()); // current id -> id the pairs use
+    iota(original.begin(), original.end(), 0);
+
+    cout << "order\treorder_ms\tdijkstra_ms\tbfs_ms\tdijkstra_paths\tbfs_paths" << endl;
+    uint64_t first_sums[2] = {0, 0};
+    for(size_t o = 0; o < 4; o++) {
+        Timer timer;
+        timer.begin_timer();
+        vector<uint32_t> order = actor_graph.reorder(orderings[o]);
+        long long reorder_ns = timer.end_timer();
+
+        vector<uint32_t> renumbered(order.size());
+        vector<uint32_t> current(order.size()); // id the pairs use -> current id
+        for(uint32_t a = 0; a < order.size(); a++) {
+            renumbered[a] = original[order[a]];
+            current[renumbered[a]] = a;
+        }
+        original.swap(renumbered);
+
+        PathWorker worker;
+        actor_graph.initWorkspace(worker.ws);
+        actor_graph.initWorkspace(worker.back_ws);
+
+        vector<pair<uint32_t, uint32_t>> renumbered_pairs;
+        for(auto& p: pairs) {
+            renumbered_pairs.emplace_back(current[p.first], current[p.second]);
+        }
+
+        long long search_ns[2];
+        uint64_t sums[2];
+        const SearchEngine engines[] = {HEAP_DIJKSTRA, BIDIRECTIONAL_BFS};
+        for(size_t e = 0; e < 2; e++) {
+            search_ns[e] = timePaths(actor_graph.adjacency(), worker, engines[e], renumbered_pairs,
+                                     sums[e]);
+        }
+
+        cout << names[o] << "\t" << reorder_ns / 1000000 << "\t" << search_ns[0] / 1000000
+             << "\t" << search_ns[1] / 1000000 << "\t" << sums[0] << "\t" << sums[1] << endl;
+
+        if(o == 0) {
+            first_sums[0] = sums[0];
+            first_sums[1] = sums[1];
+        }
+        else if(sums[0] != first_sums[0] || sums[1] != first_sums[1]) {
+            cerr << "The " << names[o] << " order changed the paths" << endl;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**Function to time a scan over every edge
+ * Purpose: Calls forEachEdge() on every actor and returns the nanoseconds it
+ *      took, checksum sums the neighbors and movies of every edge **/
+template<class Graph>
+long long timeScan(const Graph& graph, SearchWorkspace& ws, uint64_t& checksum) {
+    Timer timer;
+    checksum = 0;
+    timer.begin_timer();
+    for(uint32_t a = 0; a < graph.numNodes(); a++) {
+        graph.forEachEdge(a, ws, [&](uint32_t next, int weight, uint32_t movie) {
+            checksum += next + weight + movie;
+        });
+    }
+    return timer.end_timer();
+}
+
+/**Function to compare the clique as CsrGraph and as CompressedGraph
+ * Purpose: Times the compressed build, prints the bytes per edge of both
+ *      and times scanning every edge, dijkstra on the heap and the
+ *      bidirectional BFS on both.  Then renumbers the actors in bfs order
+ *      and prints the bytes per edge again, gaps between close ids are
+ *      shorter.  Both adjacencies have to give the same edges and paths **/
+int benchCompress(ActorGraph& actor_graph, const BenchOptions& opts) {
+    const CsrGraph& csr = actor_graph.adjacency();
+    const CompressedGraph& packed = actor_graph.compressed();
+    Timer timer;
+    timer.begin_timer();
+    actor_graph.buildCompressed();
+    long long build_ns = timer.end_timer();
+
+    uint64_t num_edges = csr.numEdges();
+    size_t csr_bytes = csr.offsets.size() * sizeof(uint64_t) +
+                       num_edges * (sizeof(uint32_t) + sizeof(int) + sizeof(uint32_t));
+    cout << "edges " << num_edges << ", packed movie ids of " << packed.movieWidth()
+         << " bits, compressed build " << build_ns / 1000000 << " ms" << endl;
+
+    PathWorker worker;
+    actor_graph.initWorkspace(worker.ws);
+    actor_graph.initWorkspace(worker.back_ws);
+    vector<pair<uint32_t, uint32_t>> pairs = randomPairs(actor_graph, opts);
+
+    uint64_t sums[2][3];
+    long long times[2][3];
+    times[0][0] = timeScan(csr, worker.ws, sums[0][0]);
+    times[1][0] = timeScan(packed, worker.ws, sums[1][0]);
+    times[0][1] = timePaths(csr, worker, HEAP_DIJKSTRA, pairs, sums[0][1]);
+    times[1][1] = timePaths(packed, worker, HEAP_DIJKSTRA, pairs, sums[1][1]);
+    times[0][2] = timePaths(csr, worker, BIDIRECTIONAL_BFS, pairs, sums[0][2]);
+    times[1][2] = timePaths(packed, worker, BIDIRECTIONAL_BFS, pairs, sums[1][2]);
+
+    cout << "adjacency\tMB\tbytes_per_edge\tscan_ns_per_edge\tdijkstra_ms\tbfs_ms" << endl;
+    const char* names[] = {"csr", "compressed"};
+    size_t bytes[] = {csr_bytes, packed.memoryBytes()};
+    for(size_t g = 0; g < 2; g++) {
+        cout << names[g] << "\t" << bytes[g] / 1000000 << "\t" << (double) bytes[g] / max<uint64_t>(num_edges, 1)
+             << "\t" << (double) times[g][0] / max<uint64_t>(num_edges, 1) << "\t"
+             << times[g][1] / 1000000 << "\t" << times[g][2] / 1000000 << endl;
+    }
+
+    actor_graph.reorder(BFS_ORDER);
+    cout << "compressed_bfs_order\t" << packed.memoryBytes() / 1000000 << "\t"
+         << (double) packed.memoryBytes() / max<uint64_t>(num_edges, 1) << endl;
+
+    for(size_t k = 0; k < 3; k++) {
+        if(sums[0][k] != sums[1][k]) {
+            cerr << "The compressed adjacency gave other " << (k == 0 ? "edges" : "paths") << endl;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**Function to compare the delimiter kernels and the loaders
+ * Purpose: Scans the whole mapped cast file with every supported kernel,
+ *      then loads it with loadFromFile and loadFromMappedFile on the best
+ *      kernel.  Prints MB/s of each and the time every stage of the stream
+ *      loader spent working and waiting.  The kernels have to find the
+ *      same delimiters and the loaders the same graph **/
+int benchParse(const char* filename, unsigned num_threads) {
+    MappedFile file;
+    if(!file.open(filename)) {
+        cerr << "Could not read " << filename << endl;
+        return -1;
+    }
+    string_view text = file.view();
+    double mb = text.size() / 1e6;
+    const char* best = TsvScanner::currentName();
+
+    cout << "step\tms\tMB_per_s\tchecksum" << endl;
+    const char* kernels[] = {"scalar", "sse2", "avx2"};
+    uint64_t first_sum = 0;
+    bool have_first = false;
+    for(const char* name: kernels) {
+        if(!TsvScanner::use(name)) continue;
+
+        Timer timer;
+        timer.begin_timer();
+        vector<uint32_t> delims(4096);
+        uint64_t sum = 0;
+        for(size_t base = 0; base < text.size(); ) {
+            size_t count = 0;
+            size_t end = min(text.size() - base, TsvScanner::MAX_SCAN);
+            size_t next = TsvScanner::current()(text.data() + base, 0, end, delims.data(),
+                                                delims.size(), count);
+            for(size_t i = 0; i < count; i++) {
+                sum = sum * 31 + base + delims[i];
+            }
+            base += next;
+        }
+        long long ns = timer.end_timer();
+        cout << "scan_" << name << "\t" << ns / 1000000 << "\t" << mb * 1e9 / max(ns, 1LL)
+             << "\t" << sum << endl;
+
+        if(have_first && sum != first_sum) {
+            cerr << "The " << name << " kernel found other delimiters" << endl;
+            return -1;
+        }
+        first_sum = sum;
+        have_first = true;
+    }
+    TsvScanner::use(best);
+
+    uint64_t sums[2];
+    LoadStats stream_stats;
+    const char* loaders[] = {"load_stream", "load_mapped"};
+    for(size_t l = 0; l < 2; l++) {
+        ActorGraph graph;
+        graph.setThreads(num_threads);
+        Timer timer;
+        timer.begin_timer();
+        bool ok = l == 0 ? graph.loadFromFile(filename, false) : graph.loadFromMappedFile(filename, false);
+        long long ns = timer.end_timer();
+        if(!ok) return -1;
+
+        sums[l] = graph.numActors();
+        for(uint32_t m = 0; m < graph.numMovies(); m++) {
+            for(uint32_t a: graph.getMovie(m).getCast()) {
+                sums[l] = sums[l] * 31 + a;
+            }
+            sums[l] = sums[l] * 31 + graph.getMovie(m).year;
+        }
+        cout << loaders[l] << "_" << best << "\t" << ns / 1000000 << "\t"
+             << mb * 1e9 / max(ns, 1LL) << "\t" << sums[l] << endl;
+        if(l == 0) stream_stats = graph.loadStats();
+    }
+
+    // the stage with the most busy time per thread holds the others up
+    const LoadStats& s = stream_stats;
+    cout << "stage\tthreads\tbusy_ms\twait_ms\tMB_per_busy_s" << endl;
+    const char* stages[] = {"read", "parse", "merge"};
+    unsigned threads[] = {1, s.parsers, 1};
+    long long busy[] = {s.read_ns, s.parse_ns, s.merge_ns};
+    long long wait[] = {s.read_wait_ns, s.parse_wait_ns, s.merge_wait_ns};
+    for(size_t k = 0; k < 3; k++) {
+        cout << stages[k] << "\t" << threads[k] << "\t" << busy[k] / 1000000 << "\t"
+             << wait[k] / 1000000 << "\t" << s.bytes / 1e6 * 1e9 * threads[k] / max(busy[k], 1LL) << endl;
+    }
+    cout << s.blocks << " blocks, " << s.rows << " rows in " << s.total_ns / 1000000 << " ms" << endl;
+    if(sums[0] != sums[1]) {
+        cerr << "The loaders built different graphs" << endl;
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned num_threads = Utils::takeThreads(argc, argv);
+    const char* num_pairs = Utils::takeOption(argc, argv, "--pairs");
+    const char* seed = Utils::takeOption(argc, argv, "--seed");
+    const char* num_landmarks = Utils::takeOption(argc, argv, "--landmarks");
+
+    BenchOptions opts;
+    opts.num_pairs = num_pairs == nullptr ? 1000 : strtoul(num_pairs, nullptr, 10);
+    opts.seed = seed == nullptr ? 1 : strtoul(seed, nullptr, 10);
+    opts.num_landmarks = num_landmarks == nullptr ? 16 : strtoul(num_landmarks, nullptr, 10);
+    opts.use_bipartite = Utils::takeFlag(argc, argv, "--bipartite");
+
+    if(argc != 3) {
+        cerr << "Invalid amount of arguments" << endl;
+        cerr << "Example: ./graphbench queue|ufind|connect|alt|bfs|cache|order|compress|parse movie_casts.tsv [--pairs N] [--seed N]"
+             << " [--landmarks K] [--threads N] [--bipartite]" << endl;
+        return -1;
+    }
+    string bench = argv[1];
+    if(bench == "parse") {
+        return benchParse(argv[2], num_threads);
+    }
+
+    ActorGraph actor_graph;
+    actor_graph.setThreads(num_threads);
+    if(!actor_graph.loadFromMappedFile(argv[2], true) || actor_graph.numActors() == 0) {
+        cerr << "Could not load any actors from " << argv[2] << endl;
+        return -1;
+    }
+
+    cout << argv[2] << ": " << actor_graph.numActors() << " actors, "
+         << actor_graph.numMovies() << " movies, weights " << actor_graph.minWeight()
+         << ".." << actor_graph.maxWeight() << endl;
+
+    if(bench == "ufind") {
+        return benchUfind(actor_graph, opts);
+    }
+    if(bench == "connect") {
+        return benchConnect(actor_graph, opts);
+    }
+
+    if(opts.use_bipartite) {
+        actor_graph.buildBipartite();
+    }
+    else {
+        actor_graph.build();
+    }
+
+    if(bench == "bfs") {
+        if(opts.use_bipartite) {
+            cerr << "bfs searches the clique adjacency, drop --bipartite" << endl;
+            return -1;
+        }
+        return benchBFS(actor_graph, opts);
+    }
+    if(bench == "order") {
+        if(opts.use_bipartite) {
+            cerr << "order searches the clique adjacency, drop --bipartite" << endl;
+            return -1;
+        }
+        return benchOrder(actor_graph, opts);
+    }
+    if(bench == "compress") {
+        if(opts.use_bipartite) {
+            cerr << "compress compares the clique adjacencies, drop --bipartite" << endl;
+            return -1;
+        }
+        return benchCompress(actor_graph, opts);
+    }
+    if(bench == "alt") {
+        return opts.use_bipartite ? benchAlt(actor_graph, actor_graph.incidence(), opts) :
+                                    benchAlt(actor_graph, actor_graph.adjacency(), opts);
+    }
+    if(bench == "cache") {
+        return opts.use_bipartite ? benchCache(actor_graph, actor_graph.incidence(), opts) :
+                                    benchCache(actor_graph, actor_graph.adjacency(), opts);
+    }
+    if(bench == "queue") {
+        return opts.use_bipartite ? benchQueue(actor_graph, actor_graph.incidence(), opts) :
+                                    benchQueue(actor_graph, actor_graph.adjacency(), opts);
+    }
+
+    cerr << "Unknown benchmark " << bench << endl;
+    return -1;
+}
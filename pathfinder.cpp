@@ -3,48 +3,255 @@
  * File: pathfinder.cpp
  *     Purpose: To find the shortest path between a pair of actors.
  *     -> 4 command arguments :
- *      (1) Name of text file containing the movie casts
+ *      (1) Name of text file containing the movie casts, - to read them
+ *          from the standard input
  *      (2) u or w (unweighted or weighted path)
  *      (3) Name of text file containing actors to find the paths.
  *      (4) Name of output file
+ *     -> options :
+ *      --threads N  number of threads used to load the movie casts and to
+ *                   answer the pairs, results are written in input order
+ *      --bipartite  search the actor <-> movie incidence lists instead of
+ *                   building a co-star clique for every movie
+ *      --compressed  search the co-star clique stored as varint gaps, for
+ *                   casts whose clique does not fit as it is, see
+ *                   CompressedGraph.h.  Not with --bipartite or snapshots
+ *      --save-snapshot FILE  write the built graph to a binary snapshot
+ *      --load-snapshot FILE  use a snapshot instead of reading (1), it must
+ *                   have been saved with the same u/w and --bipartite
+ *      --queue heap|bucket  priority queue of the weighted search, bucket
+ *                   (the default) falls back to heap for weights below 1
+ *      --msbfs      answer unweighted pairs with one multi-source BFS per 64
+ *                   distinct starting actors of a batch instead of a search
+ *                   per pair.  Needs 100 bytes per actor and thread
+ *      --landmarks K  answer weighted pairs with A* aimed by the distances
+ *                   from K landmark actors (ALT), picked after building the
+ *                   graph.  A snapshot saved with landmarks keeps them and
+ *                   they are used as they are
+ *      --cache N    keep the shortest path trees of the last N starting
+ *                   actors and answer later pairs from them when they reach
+ *                   far enough.  Prints the hits and misses at the end
+ *      --reorder bfs|degree|rcm  renumber the actors after building the
+ *                   graph so actors searched together sit close in memory,
+ *                   see NodeOrder.h.  The paths are the same as without it
+ *     -> the pairs of a batch are grouped by starting actor, a starting actor
+ *        with several pairs gets one search that reaches all their ends
  */
 #include <iostream>
+#include <algorithm>
 #include <fstream>
 #include <queue>
-#include <stack>
+#include <string_view>
+#include <vector>
 #include "ActorNode.h"
 #include "Movie.h"
 #include "ActorGraph.h"
 #include "ActorGraph.cpp"
+#include "MultiSourceBFS.h"
+#include "MultiSourceBFS.cpp"
+#include "PathTreeCache.h"
+#include "PathTreeCache.cpp"
+#include "PathSearch.h"
+#include "util.h"
+#include "util.cpp"
 using namespace std;
 
+// pairs answered together, results are written out after each batch
+const size_t BATCH_SIZE = 4096;
+
+/** one line of the pairs file and what answering it printed **/
+struct PairQuery
+{
+    string line;
+    uint32_t start; // the actors of line, NO_ID if unknown
+    uint32_t end;
+    string path;  // line for the outfile, empty if there is no path
+    string error; // message for cerr instead of a path
+};
+
+/**Function to look up the actors of one line of the pairs file
+ * Purpose: Sets query.start and query.end, returns false and sets query.error
+ *      if either is unknown **/
+bool lookupPair(const ActorGraph* actor_graph, PairQuery& query) {
+    string_view record[2];
+    size_t fields = TsvReader::splitRecord(query.line, record, 2);
+
+    query.start = fields < 1 ? NO_ID : actor_graph->getActor(record[0]); // the starting actor
+    query.end = fields < 2 ? NO_ID : actor_graph->getActor(record[1]); // the ending actor
+
+    if(query.start == NO_ID || query.end == NO_ID) {
+        query.error = "Unknown actor in pair: " + query.line;
+        return false;
+    }
+    return true;
+}
+
+/**Function to format the path a search left in ws
+ * Purpose: Writes the path from query.start to query.end into query.path,
+ *      or the reason there is none into query.error **/
+void formatPath(const ActorGraph* actor_graph, SearchWorkspace& ws, PairQuery& query) {
+    uint32_t start = query.start;
+    uint32_t end = query.end;
+
+    if(ws.dist(end) == numeric_limits<int>::max()) {
+        query.error = "No path between " + string(actor_graph->actorName(start)) + " and " +
+                      string(actor_graph->actorName(end));
+        return;
+    }
+
+    // collect the path from end to beginning
+    vector<uint32_t> path;
+    for(uint32_t curr = end; curr != start; curr = ws.prev(curr)) {
+        path.push_back(curr);
+    }
+
+    // format it from the beginning
+    query.path.append("(").append(actor_graph->actorName(start)).append(")");
+    for(size_t i = path.size(); i-- > 0; ) {
+        query.path.append("--[").append(actor_graph->movieName(ws.prevMovie(path[i])))
+                  .append("]-->(").append(actor_graph->actorName(path[i])).append(")");
+    }
+}
+
+/**Function to answer the pairs of one starting actor
+ * Purpose: Answers a lone pair with the search of engine.  Several pairs,
+ *      and every pair once there is a cache, are answered from a single
+ *      shortest path tree of the starting actor, taken from the cache if it
+ *      has one that reaches every end.  [first, last) all have the same
+ *      starting actor **/
+template<class Graph>
+void findPathsFromTree(const ActorGraph* actor_graph, const Graph& graph, PathWorker& worker,
+                       SearchEngine engine, PathTreeCache* cache,
+                       vector<PairQuery*>::const_iterator first,
+                       vector<PairQuery*>::const_iterator last) {
+    uint32_t start = (*first)->start;
+    if(last - first == 1 && cache == nullptr) {
+        findShortestPath(graph, worker, engine, start, (*first)->end);
+        formatPath(actor_graph, worker.ws, **first);
+        return;
+    }
+
+    vector<uint32_t> targets;
+    for(auto it = first; it != last; ++it) {
+        targets.push_back((*it)->end);
+    }
+    sort(targets.begin(), targets.end());
+    targets.erase(unique(targets.begin(), targets.end()), targets.end());
+
+    shared_ptr<const PathTree> tree = cache == nullptr ? nullptr : cache->get(start, targets);
+    if(tree == nullptr) {
+        tree = findPathTree(graph, worker, engine, start, targets);
+        if(cache != nullptr) cache->put(tree);
+    }
+
+    for(auto it = first; it != last; ++it) {
+        tree->writePath((*it)->end, worker.ws);
+        formatPath(actor_graph, worker.ws, **it);
+    }
+}
+
+/**Function to answer the pairs of up to 64 starting actors together
+ * Purpose: Runs one multi-source BFS from the distinct starting actors of
+ *      the queries in [first, last), which are sorted by starting actor, and
+ *      formats every path.  Pairs further apart than the search can count
+ *      fall back to the bidirectional BFS **/
+template<class Graph>
+void findPathsFrom(const ActorGraph* actor_graph, const Graph& graph, PathWorker& worker,
+                   MultiSourceBFS& msbfs, vector<PairQuery*>::const_iterator first,
+                   vector<PairQuery*>::const_iterator last) {
+    vector<uint32_t> sources; // index of the starting actor of every query
+    msbfs.clear();
+    for(auto it = first; it != last; ++it) {
+        if(it == first || (*it)->start != it[-1]->start) {
+            msbfs.addSource((*it)->start);
+        }
+        sources.push_back(msbfs.numSources() - 1);
+        msbfs.want(sources.back(), (*it)->end);
+    }
+    msbfs.search(graph, worker.ws);
+
+    for(auto it = first; it != last; ++it) {
+        PairQuery& query = **it;
+        uint32_t source = sources[it - first];
+
+        if(msbfs.dist(source, query.end) != INT_MAX) {
+            msbfs.tracePath(graph, worker.ws, worker.back_ws, source, query.start, query.end);
+        }
+        else if(!msbfs.isComplete()) {
+            findShortestPath(graph, worker, BIDIRECTIONAL_BFS, query.start, query.end);
+        }
+        else {
+            worker.ws.reset(); // no path
+        }
+        formatPath(actor_graph, worker.ws, query);
+    }
+}
+
 int main(int argc, char* argv[]) {
-    ifstream in1(argv[1]);
-    ifstream in3(argv[3]);
-    ifstream in4(argv[4]);
-    string typeOfWeight = argv[2];
+    unsigned num_threads = Utils::takeThreads(argc, argv);
+    bool use_bipartite = Utils::takeFlag(argc, argv, "--bipartite");
+    bool use_compressed = Utils::takeFlag(argc, argv, "--compressed");
+    const char* save_snapshot = Utils::takeOption(argc, argv, "--save-snapshot");
+    const char* load_snapshot = Utils::takeOption(argc, argv, "--load-snapshot");
+    const char* queue_name = Utils::takeOption(argc, argv, "--queue");
+    bool use_msbfs = Utils::takeFlag(argc, argv, "--msbfs");
+    const char* cache_size = Utils::takeOption(argc, argv, "--cache");
+    const char* landmark_count = Utils::takeOption(argc, argv, "--landmarks");
+    const char* reorder_name = Utils::takeOption(argc, argv, "--reorder");
 
     /** Null checks **/
     //Check if not 4 arguments after calling ./pathfinder
     if(argc != 5) {
         cerr << "Invalid amount of arguments" << endl;
         cerr << "Example: ./pathfinder movie_casts.tsv u test_pairs.tsv"  
-             << "out_paths_unweighted.tsv" << endl;
+             << "out_paths_unweighted.tsv [--threads N] [--bipartite]"
+             << " [--compressed] [--save-snapshot FILE] [--load-snapshot FILE] [--queue heap|bucket]"
+             << " [--msbfs] [--cache N] [--landmarks K] [--reorder bfs|degree|rcm]" << endl;
         return -1;
     }
 
+    bool from_stdin = string(argv[1]) == "-"; // read the casts from a pipe
+    ifstream in1(argv[1]);
+    ifstream in3(argv[3]);
+    string typeOfWeight = argv[2];
+
     //Check if argv[2] is not u or w
     if(typeOfWeight != "w"  && typeOfWeight!= "u") {
         cerr << "argument needs to be either u or w" << endl;
         return -1;
     }
+    if(queue_name != nullptr && string(queue_name) != "heap" && string(queue_name) != "bucket") {
+        cerr << "--queue needs to be either heap or bucket" << endl;
+        return -1;
+    }
+    if(use_msbfs && typeOfWeight != "u") {
+        cerr << "--msbfs only works with u" << endl;
+        return -1;
+    }
+    if(landmark_count != nullptr && (typeOfWeight != "w" || atoi(landmark_count) < 1)) {
+        cerr << "--landmarks needs w and at least 1 landmark" << endl;
+        return -1;
+    }
+    NodeOrdering ordering = NATURAL_ORDER;
+    if(reorder_name != nullptr && !parseNodeOrdering(reorder_name, ordering)) {
+        cerr << "--reorder needs to be bfs, degree or rcm" << endl;
+        return -1;
+    }
+    if(use_compressed && (use_bipartite || save_snapshot != nullptr || load_snapshot != nullptr)) {
+        cerr << "--compressed does not go with --bipartite or snapshots" << endl;
+        return -1;
+    }
+    if(use_msbfs && cache_size != nullptr) {
+        cerr << "--msbfs does not build trees for --cache" << endl;
+        return -1;
+    }
 
     //Check if argv[1] is invalid
-    if(!in1.good()) {
+    if(load_snapshot == nullptr && !from_stdin && !in1.good()) {
         cerr << "argv[1]File does not exist" << endl;
         return -1;
     }
-    if(in1.peek() == ifstream::traits_type::eof()) {
+    if(load_snapshot == nullptr && !from_stdin && in1.peek() == ifstream::traits_type::eof()) {
         cout << "argv[1] File is empty" << endl;
         return -1;
     }
@@ -60,108 +267,174 @@ int main(int argc, char* argv[]) {
     }
 
     ActorGraph* actor_graph = new ActorGraph(); //initialize graph
+    actor_graph->setThreads(num_threads);
 
     //open the input file and output files
     ofstream outfile;
     outfile.open(argv[4], ios::binary);
     outfile << "(actor)--[movie#@year]-->(actor)--...\n"; //header
     
-    ActorNode* start;
-    ActorNode* end;
-    ActorNode* curr;
+    if(load_snapshot != nullptr) { // the graph has already been built
+        if(!actor_graph->loadSnapshot(load_snapshot)) return -1;
 
-    if(typeOfWeight == "u") { // use default dummy weights of 1
-    	actor_graph->loadFromFile(argv[1], false);
+        WeightMode expected = typeOfWeight == "w" ? AGE_WEIGHTS : UNIT_WEIGHTS;
+        bool has_layout = use_bipartite ? actor_graph->hasBipartite() : actor_graph->hasClique();
+        if(actor_graph->weightMode() != expected || !has_layout) {
+            cerr << load_snapshot << " was not saved with these u/w and --bipartite settings" << endl;
+            return -1;
+        }
     }
-    if(typeOfWeight == "w") { // use calculated weights of each edge
-    	actor_graph->loadFromFile(argv[1], true);
+    else {
+        bool weighted = typeOfWeight == "w"; // else use default dummy weights of 1
+        bool loaded = from_stdin ? actor_graph->loadFromFile(argv[1], weighted) :
+                                   actor_graph->loadFromMappedFile(argv[1], weighted);
+        if(!loaded) return -1;
+
+        if(use_bipartite) {
+            actor_graph->buildBipartite(); // only record the movies of each actor
+        }
+        else if(use_compressed) {
+            actor_graph->buildCompressed(); // the edges as varint gaps
+        }
+        else {
+            actor_graph->build(); // create the edges between the vertices
+        }
     }
 
-    actor_graph->build(); // create the edges between the vertices
+    if(ordering != NATURAL_ORDER) {
+        actor_graph->reorder(ordering);
+    }
 
-    bool have_header = false;
-    // find the shortest path between the two specified nodes
-    while(in3) {
-    	string line;
+    // the landmark table of a snapshot is used as it is
+    bool use_landmarks = landmark_count != nullptr && actor_graph->minWeight() >= 1;
+    if(landmark_count != nullptr && !use_landmarks) {
+        cerr << "Weights below 1, searching without landmarks" << endl;
+    }
+    if(use_landmarks && !actor_graph->landmarkTable().built()) {
+        actor_graph->buildLandmarks(atoi(landmark_count));
+    }
 
-        // get the next line
-    	if (!getline( in3, line )) break;
+    if(save_snapshot != nullptr) {
+        if(!actor_graph->saveSnapshot(save_snapshot)) return -1;
+    }
 
-        if (!have_header) {
-            // skip the header
-            have_header = true;
-            continue;
+    // unit weights are searched by a bidirectional BFS, others by dijkstra
+    // on a bucket queue unless asked for the heap or a weight is below 1
+    SearchEngine engine = BIDIRECTIONAL_BFS;
+    if(typeOfWeight == "w") {
+        engine = BUCKET_DIJKSTRA;
+        if(queue_name != nullptr && string(queue_name) == "heap") {
+            engine = HEAP_DIJKSTRA;
         }
+        else if(actor_graph->minWeight() < 1) {
+            if(queue_name != nullptr) {
+                cerr << "Weights below 1, using the heap instead of the bucket queue" << endl;
+            }
+            engine = HEAP_DIJKSTRA;
+        }
+        if(use_landmarks) {
+            engine = ALT_ASTAR;
+        }
+    }
 
-		istringstream ss(line);
-		vector<string> record;
-
-		// get the names of the starting and ending vertices
-		while(ss) {
-			string next;
-			if(!getline(ss, next, '\t')) break;
-
-		  	record.push_back(next);
-		}
+    // every thread searches with workspaces and queues of its own
+    ThreadPool& threads = actor_graph->threads();
+    vector<PathWorker> workers(threads.size());
+    for(auto& w: workers) {
+        actor_graph->initWorkspace(w.ws);
+        actor_graph->initWorkspace(w.back_ws);
+        w.landmarks = &actor_graph->landmarkTable();
+        if(engine == BUCKET_DIJKSTRA) {
+            w.buckets.init(actor_graph->maxWeight());
+        }
+    }
+    unique_ptr<PathTreeCache> cache;
+    if(cache_size != nullptr) {
+        cache.reset(new PathTreeCache(strtoul(cache_size, nullptr, 10)));
+    }
+    vector<MultiSourceBFS> msbfs(use_msbfs ? threads.size() : 0);
+    for(auto& m: msbfs) {
+        m.resize(actor_graph->numActors());
+    }
+    vector<PairQuery*> by_start; // known pairs of a batch sorted by starting actor
+    vector<size_t> groups;       // start of the pairs of each search in by_start
 
-		actor_graph->resetNodes(); // reinitialize each vertices dist,prev,done
-	    start = actor_graph->getActor(record[0]); // the starting ActorNode
-		end = actor_graph->getActor(record[1]); // the ending ActorNode
+    string header;
+    getline(in3, header); // skip the header
 
-		priority_queue<ActorNode*, vector<ActorNode*>, ActorPtrComp> pq;
+    // find the shortest path between every pair, a batch at a time
+    vector<PairQuery> batch(BATCH_SIZE);
+    while(in3) {
+        size_t batch_size = 0;
+        while(batch_size < BATCH_SIZE && getline(in3, batch[batch_size].line)) {
+            batch[batch_size].path.clear();
+            batch[batch_size].error.clear();
+            batch_size++;
+        }
 
-		/** perform dijkstra's algorithm **/
-		start->dist = 0;
-		pq.push(start); // enqueue weight of 0 with starting vertex
+        // group the pairs by starting actor, a group for every starting
+        // actor or for every MAX_SOURCES of them with --msbfs
+        by_start.clear();
+        for(size_t i = 0; i < batch_size; i++) {
+            if(lookupPair(actor_graph, batch[i])) by_start.push_back(&batch[i]);
+        }
+        stable_sort(by_start.begin(), by_start.end(), [](const PairQuery* a, const PairQuery* b) {
+            return a->start < b->start;
+        });
 
-        int weight;
-        int total_dist;
+        groups.clear();
+        uint32_t group_sources = use_msbfs ? MultiSourceBFS::MAX_SOURCES : 1;
+        uint32_t sources = 0;
+        for(size_t i = 0; i < by_start.size(); i++) {
+            if(i > 0 && by_start[i]->start == by_start[i - 1]->start) continue;
+            if(sources++ % group_sources == 0) groups.push_back(i);
+        }
+        groups.push_back(by_start.size());
 
-        ActorNode* neighbor;
-		while(!pq.empty()) {
-			curr = pq.top();
-			pq.pop();
+        threads.parallelFor(groups.size() - 1, [&](size_t g, unsigned worker) {
+            auto first = by_start.cbegin() + groups[g];
+            auto last = by_start.cbegin() + groups[g + 1];
+            if(use_msbfs && use_bipartite) {
+                findPathsFrom(actor_graph, actor_graph->incidence(), workers[worker],
+                              msbfs[worker], first, last);
+            }
+            else if(use_msbfs && use_compressed) {
+                findPathsFrom(actor_graph, actor_graph->compressed(), workers[worker],
+                              msbfs[worker], first, last);
+            }
+            else if(use_msbfs) {
+                findPathsFrom(actor_graph, actor_graph->adjacency(), workers[worker],
+                              msbfs[worker], first, last);
+            }
+            else if(use_bipartite) {
+                findPathsFromTree(actor_graph, actor_graph->incidence(), workers[worker],
+                                  engine, cache.get(), first, last);
+            }
+            else if(use_compressed) {
+                findPathsFromTree(actor_graph, actor_graph->compressed(), workers[worker],
+                                  engine, cache.get(), first, last);
+            }
+            else {
+                findPathsFromTree(actor_graph, actor_graph->adjacency(), workers[worker],
+                                  engine, cache.get(), first, last);
+            }
+        });
 
-            if(typeOfWeight == "w") { // if using weighted paths
-                if(curr == end) break; // end djikstra's when finding the end node
+        // write the paths to the outfile in the order of the pairs
+        for(size_t i = 0; i < batch_size; i++) {
+            if(!batch[i].error.empty()) {
+                cerr << batch[i].error << endl;
+            }
+            else {
+                outfile << batch[i].path << "\n";
             }
+        }
+    }
 
-			if(!curr->done) { 
-				curr->done = true;
-				for(unsigned int i = 0; i < curr->neighborSize(); i++) {
-					neighbor = curr->neighbors[i];
-					weight = curr->edge_map[neighbor].second;
-					total_dist = curr->dist + weight;
-					
-					if(total_dist < neighbor->dist) {
-						neighbor->prev = curr;
-						neighbor->dist = total_dist;
-						pq.push(neighbor);
-					}
-				}
-			}
-		}
-
-		// add the path from end to beginning onto a stack
-		stack<ActorNode*> path;
-		path.push(end);
-
-		curr = end;
-		while(curr->prev != start) { //pushes curr->prev to the stack  
-			path.push(curr->prev);
-			curr = curr->prev;
-		}
-
-		path.push(start);
-
-		// write the path to the outfile
-		while(path.top() != end) {
-			curr = path.top();
-			path.pop();
-			outfile << "(" << curr->name << ")--[" << curr->edge_map[path.top()].first << "]-->";
-		}
-		outfile << "(" << end->name << ")" << endl;
-	}
+    if(cache != nullptr) {
+        cout << "Path tree cache: " << cache->hits() << " hits, " << cache->misses()
+             << " misses" << endl;
+    }
 
     //close the files
 	in1.close();
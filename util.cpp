@@ -1,5 +1,8 @@
 #include <iostream>
 #include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
 #include "util.h"
 
 using std::istream;
@@ -31,3 +34,51 @@ long long Timer::end_timer()
 }
 
 
+
+
+/*
+ * Finds "name value" on the command line and removes both words from argv.
+ */
+const char* Utils::takeOption(int& argc, char* argv[], const char* name)
+{
+    for(int i = 1; i + 1 < argc; i++) {
+        if(std::strcmp(argv[i], name) != 0) continue;
+
+        const char* value = argv[i + 1];
+        for(int j = i; j + 2 <= argc; j++) {
+            argv[j] = argv[j + 2]; // also moves the terminating nullptr
+        }
+        argc -= 2;
+        return value;
+    }
+    return nullptr;
+}
+
+/*
+ * Finds a flag on the command line and removes it from argv.
+ */
+bool Utils::takeFlag(int& argc, char* argv[], const char* name)
+{
+    for(int i = 1; i < argc; i++) {
+        if(std::strcmp(argv[i], name) != 0) continue;
+
+        for(int j = i; j + 1 <= argc; j++) {
+            argv[j] = argv[j + 1];
+        }
+        argc -= 1;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Number of threads requested with --threads, at least 1.
+ */
+unsigned Utils::takeThreads(int& argc, char* argv[])
+{
+    const char* value = takeOption(argc, argv, "--threads");
+    if(value == nullptr) return 1;
+
+    int threads = std::atoi(value);
+    return threads < 1 ? 1 : threads;
+}
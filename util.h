@@ -44,8 +44,24 @@ private:
     
 public:
 
-    
-    
+    /*
+     * Removes "name value" from the command line and returns value, or
+     * nullptr if the option was not given. argc and argv are compacted so
+     * the positional arguments keep their usual indices.
+     */
+    static const char* takeOption(int& argc, char* argv[], const char* name);
+
+    /*
+     * Removes a flag without a value from the command line. Returns
+     * whether it was given.
+     */
+    static bool takeFlag(int& argc, char* argv[], const char* name);
+
+    /*
+     * Reads an optional "--threads N" from the command line. Returns 1 if
+     * it was not given.
+     */
+    static unsigned takeThreads(int& argc, char* argv[]);
     
 };
 